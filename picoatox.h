@@ -6,6 +6,9 @@
 
 #include "picobool.h"
 
+#include <stddef.h> // size_t
+#include <stdint.h> // int32_t, uint64_t
+
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
@@ -15,7 +18,39 @@ extern "C" {
 #else
     int pico_atoi(const char *pStr, int force_base);
 #endif
-float pico_atof(const char *pStr);
+float pico_atof(const char *pStr);                  // `pico_strtof(pStr, NULL)`
+
+// `strtol()`-like parsing: the leading whitespace and sign, then the digits in `base` (2..36, or 0 to detect it from
+// the "0x", "0b", or "0" prefix); `*ppEnd` (if not NULL) is set past the last digit parsed, or to `pStr` if there is none
+// `*pErr` (if not NULL) is set to one of the following; out of range values are clamped to the limits of the type
+#define PICO_ATOX_OK        0
+#define PICO_ATOX_NO_DIGITS 1
+#define PICO_ATOX_OVERFLOW  2
+int32_t pico_strtoi32(const char *pStr, const char **ppEnd, int base, int *pErr);
+uint64_t pico_strtou64(const char *pStr, const char **ppEnd, int base, int *pErr);   // negated if '-', like `strtoull()`
+
+// `strtod()`-like parsing of the decimal numbers, "inf", "infinity" and "nan": correctly rounded (round half to even)
+// whatever the number of digits, without libm; out of range values become +-infinity or +-0, but `errno` is left alone
+// the hexadecimal floats ("0x1p-3") are not supported: they parse as 0, up to the 'x'
+// the common numbers (up to 15 digits, exponent up to 22) take a single multiplication or division; the others go
+// through a big decimal with ~800 bytes of stack, unless `PICOATOX_FAST_STRTOD` adds Eisel-Lemire in between:
+// a 10 kB table of the 128-bit powers of 5 that turns all but the ambiguous ones into a 64x128-bit multiplication
+// #define PICOATOX_FAST_STRTOD
+double pico_strtod(const char *pStr, const char **ppEnd);
+float pico_strtof(const char *pStr, const char **ppEnd);
+
+// bulk parsing of the decimal numbers in `pBuf`, up to `cbBuf`, separated by any runs of ',', ';' and whitespace (e.g. CSV
+// or telemetry), like `pico_strtoi32()` (in base 10, but to 64 bits) or `pico_strtod()`, in place: the kernels stop at
+// the delimiters; the long runs of delimiters (e.g. padded columns) are skipped 64 chars at a time (SSE2, AVX2, or SWAR)
+// returns the number of values stored; `*ppStop` is set to where the next call should resume, i.e. to the first number
+// not parsed, or to `pBuf + cbBuf`; with `pValues` full, or at a number cut by the end of the buffer, `*pErr` is
+// `PICO_ATOX_OK`, and at a malformed or out-of-range number it is `PICO_ATOX_NO_DIGITS` or `PICO_ATOX_OVERFLOW`
+// the buffer needs no null-terminator: a number ending it may go on in the next chunk, so it is left for the next call,
+// whose buffer starts with it; `PICO_LIST_LAST` marks the last chunk, whose end also ends its last number; the numbers
+// that reach into the last 8 chars of a buffer are copied out to be null-terminated, and must be shorter than 128 chars
+#define PICO_LIST_LAST 1
+size_t pico_parse_i64_list(const char *pBuf, size_t cbBuf, int64_t *pValues, size_t cMax, const char **ppStop, unsigned flags, int *pErr);
+size_t pico_parse_f64_list(const char *pBuf, size_t cbBuf, double *pValues, size_t cMax, const char **ppStop, unsigned flags, int *pErr);
 
 bool pico_isboolean(const char *pStr);
 bool pico_atob(const char *pStr);
@@ -0,0 +1,658 @@
+#include "picoprintf.h"
+#include "picolog.h"
+#include "picoatox.h"
+#include "picoscanf.h"
+#include "picoio.h"
+
+#include <stdio.h>  // printf() for the report, snprintf() for comparison
+#include <stdlib.h> // strtol() and strtoull() for comparison
+#include <string.h> // strstr()
+#include <time.h>   // clock_gettime()
+#include <fcntl.h>  // open() of /dev/null for the threaded logging
+#include <unistd.h> // write()
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // __rdtsc()
+#endif // x86
+
+
+#ifdef __RUN_COMPARISON_TESTS__
+// comparison benchmarks require cloning the following projects into the same directory (see picotest.c)
+#include "mpaland.h"
+#include "tinyprintf.h"
+#include "nanoprintf.h"
+// mpaland's printf requires this function:
+void _putchar(char character) {}
+#endif //__RUN_COMPARISON_TESTS__
+
+
+char pBenchBuf[0x200];
+volatile int g_sink;                    // keeps the compiler from dropping the benchmarked calls
+const char *volatile g_pShortString = "info";   // keeps the compiler from turning snprintf("%s") into memcpy()
+
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+// cycles, where the CPU has a cheap counter: the TSC on x86 (which ticks at the nominal, not the boosted, frequency)
+// elsewhere, `-DPICOBENCH_CPU_GHZ=...` derives the cycles from the nanoseconds, or the column stays empty
+static double now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return (double)__rdtsc();
+#elif defined(PICOBENCH_CPU_GHZ)
+    return now_ns() * PICOBENCH_CPU_GHZ;
+#else
+    return 0;
+#endif // cycle counters
+}
+
+
+// the feature macros this binary was built with: the first CSV column, so that the runs of several builds can be concatenated
+static const char *g_pConfig = "base"
+#ifdef PICOFORMAT_HANDLE_FILL
+    "+fill"
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_FORCEDSIGN
+    "+sign"
+#endif // PICOFORMAT_HANDLE_FORCEDSIGN
+#ifdef PICOFORMAT_HANDLE_BIN
+    "+bin"
+#endif // PICOFORMAT_HANDLE_BIN
+#ifdef PICOFORMAT_HANDLE_OCT
+    "+oct"
+#endif // PICOFORMAT_HANDLE_OCT
+#ifdef PICOFORMAT_HANDLE_HEX
+    "+hex"
+#endif // PICOFORMAT_HANDLE_HEX
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+    "+hexdump"
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+#ifdef PICOFORMAT_HANDLE_ARRAYS
+    "+arrays"
+#endif // PICOFORMAT_HANDLE_ARRAYS
+#ifdef PICOATOX_FAST_STRTOD
+    "+fast_strtod"
+#endif // PICOATOX_FAST_STRTOD
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+    "+fixedpoint"
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+#ifdef PICOFORMAT_HANDLE_FLOATS
+    "+floats"
+#endif // PICOFORMAT_HANDLE_FLOATS
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+    "+exponents"
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+    "+timestamp"
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+    "+custom"
+#endif // PICOFORMAT_HANDLE_CUSTOM
+#ifdef PICOFORMAT_FAST_DECIMAL
+    "+fast_decimal"
+#endif // PICOFORMAT_FAST_DECIMAL
+#ifdef PICOFORMAT_FAST_COPY
+    "+fast_copy"
+#endif // PICOFORMAT_FAST_COPY
+#ifdef PICOFORMAT_STATS
+    "+stats"
+#endif // PICOFORMAT_STATS
+#ifdef PICOFORMAT_CLANG_QUIRK
+    "+clang_quirk"
+#endif // PICOFORMAT_CLANG_QUIRK
+    ;
+
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+unsigned char pPayload[64];
+
+// the way of dumping bytes without `pico_hexdump()`
+static int snprintf_hexdump(char *pDest, size_t cbDest, const unsigned char *pSrc, size_t cbSrc) {
+    int len = 0;
+    for (size_t ii = 0; ii < cbSrc; ii++) {
+        len += snprintf(pDest + 2 * ii, cbDest - 2 * ii, "%02x", pSrc[ii]);
+    }
+    return len;
+}
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+
+#ifdef PICOFORMAT_HANDLE_ARRAYS
+#define ARRAY_SIZE 48
+int32_t pSamples[ARRAY_SIZE];
+uint64_t pCounters[ARRAY_SIZE];
+
+// the way of exporting arrays without `pico_format_i32_array()`: a format per value
+#define SCALAR_ARRAY_LOOP(snprintfFn, format, pValues, cast) ({ \
+        int len = 0; \
+        for (size_t jj = 0; jj < ARRAY_SIZE && len < (int)sizeof(pBenchBuf); jj++) { \
+            len += snprintfFn(pBenchBuf + len, sizeof(pBenchBuf) - len, jj ? "," format : format, (cast)pValues[jj]); \
+        } \
+        len; \
+    })
+
+// returns the length, as the scalar loops do
+static int format_i32_array(void) {
+    pico_format_i32_array(pBenchBuf, sizeof(pBenchBuf), pSamples, ARRAY_SIZE, ',', 0);
+    return (int)strlen(pBenchBuf);
+}
+
+static int format_u64_array(void) {
+    pico_format_u64_array(pBenchBuf, sizeof(pBenchBuf), pCounters, ARRAY_SIZE, ',', 0);
+    return (int)strlen(pBenchBuf);
+}
+#endif // PICOFORMAT_HANDLE_ARRAYS
+
+
+// a few of each, for the lengths to vary from one call to the next
+const char *g_pShortIntegers[8] = { "7", "-42", "1234", "-99999", "65535", "8", "-1000000", "314159" };
+const char *g_pLongIntegers[8] = { "18446744073709551615", "1234567890123", "9007199254740993", "4294967296",
+                                   "1000000000000000000", "12345678901234567", "777777777777", "3141592653589793238" };
+const char *g_pHexIntegers[8] = { "deadbeefcafebabe", "0x1f", "ffffffff", "0x123456789abcdef0", "7f", "0xDEADBEEF", "abcdef", "100000000" };
+
+// the chars parsed, as the bytes of the benchmark
+#define PARSED_CHARS(parseFn, pStrings, base) ({ \
+        const char *pStr = pStrings[ii & 7]; \
+        char *pEnd; \
+        g_sink += (int)parseFn(pStr, &pEnd, base); \
+        (int)(pEnd - pStr); \
+    })
+#define PICO_PARSED_CHARS(parseFn, pStrings, base) ({ \
+        const char *pStr = pStrings[ii & 7], *pEnd; \
+        g_sink += (int)parseFn(pStr, &pEnd, base, NULL); \
+        (int)(pEnd - pStr); \
+    })
+
+
+// sensor readings, then doubles printed back with all their digits ("%.17g")
+const char *g_pReadings[8] = { "23.57", "-4.125", "1013.25", "0.003", "98.6", "-40", "3.3e-3", "65.5" };
+const char *g_pPreciseDoubles[8] = { "0.30000000000000004", "2.718281828459045", "6.02214076e+23", "1.602176634e-19",
+                                     "-123456.78901234567", "1.7976931348623157e+308", "4.9406564584124654e-324", "0.1" };
+
+#define FLOAT_PARSED_CHARS(parseFn, pStrings, endType) ({ \
+        const char *pStr = pStrings[ii & 7]; \
+        endType *pEnd; \
+        g_sink += (int)parseFn(pStr, &pEnd); \
+        (int)(pEnd - pStr); \
+    })
+
+// a telemetry row of LIST_SIZE numbers, parsed per call
+#define LIST_SIZE 64
+char pIntegerRow[LIST_SIZE * 12];
+char pReadingRow[LIST_SIZE * 12];
+int64_t pParsedIntegers[LIST_SIZE];
+double pParsedDoubles[LIST_SIZE];
+
+// the way of parsing a row without the list parsers: find the tokens by hand, one call per number; returns the chars parsed
+#define SCALAR_LIST_LOOP(parseFn, pRow, pValues, ...) ({ \
+        char *pCur = pRow; \
+        for (size_t jj = 0; jj < LIST_SIZE; jj++) { \
+            for (; ',' == *pCur || ' ' == *pCur; pCur++); \
+            pValues[jj] = parseFn(pCur, &pCur, ##__VA_ARGS__); \
+        } \
+        (int)(pCur - pRow); \
+    })
+
+static int parse_integer_row(void) {
+    const char *pStop;
+    pico_parse_i64_list(pIntegerRow, strlen(pIntegerRow), pParsedIntegers, LIST_SIZE, &pStop, PICO_LIST_LAST, NULL);
+    return (int)(pStop - pIntegerRow);
+}
+
+static int parse_reading_row(void) {
+    const char *pStop;
+    pico_parse_f64_list(pReadingRow, strlen(pReadingRow), pParsedDoubles, LIST_SIZE, &pStop, PICO_LIST_LAST, NULL);
+    return (int)(pStop - pReadingRow);
+}
+
+
+// a record of RECORD_FIELDS "key=value" pieces, assembled into `pBenchBuf` the ways without a cursor, and with `pico_buf`
+#define RECORD_FIELDS 24
+static int assemble_strlen(int ii) {        // `strlen()` before each append: the rescans grow with the record
+    pBenchBuf[0] = '\0';
+    for (int jj = 0; jj < RECORD_FIELDS; jj++) {
+        size_t len = strlen(pBenchBuf);
+        pico_snprintf(pBenchBuf + len, sizeof(pBenchBuf) - len, "f%d=%d,", jj, ii + jj);
+    }
+    return (int)strlen(pBenchBuf);
+}
+
+static int assemble_offsets(int ii) {       // the offsets by hand
+    size_t len = 0;
+    for (int jj = 0; jj < RECORD_FIELDS && len < sizeof(pBenchBuf); jj++) {
+        len += pico_snprintf(pBenchBuf + len, sizeof(pBenchBuf) - len, "f%d=%d,", jj, ii + jj);
+    }
+    return (int)len;
+}
+
+static int assemble_buf(int ii) {
+    pico_buf buf;
+    pico_binit(&buf, pBenchBuf, sizeof(pBenchBuf));
+    for (int jj = 0; jj < RECORD_FIELDS; jj++) {
+        pico_bprintf(&buf, "f%d=%d,", jj, ii + jj);
+    }
+    return (int)buf.cbUsed;
+}
+
+
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+// "%I": an IPv4 address rendered octet by octet into the output, vs. pre-formatted into a temporary buffer passed to "%s"
+static void convert_ipv4(pico_out *pOut, const pico_format_spec *pSpec, va_list *pvl) {
+    (void)pSpec;
+    unsigned address = va_arg(*pvl, unsigned);
+    pico_format_spec octet = {0};
+    octet.format = 'd';
+    octet.decimal_chars = -1;
+    octet.flags.treat_as_unsigned = 1;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        pico_emit_decimal(pOut, &octet, (address >> shift) & 0xff);
+        if (shift) {
+            pico_emit_literal(pOut, ".", 1);
+        }
+    }
+}
+
+static int format_ipv4_temporary(unsigned address, int port) {
+    char pAddress[16];
+    pico_snprintf(pAddress, sizeof(pAddress), "%u.%u.%u.%u", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff, address & 0xff);
+    return pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "peer %s:%d", pAddress, port);
+}
+#endif // PICOFORMAT_HANDLE_CUSTOM
+
+
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+// a log prefix the usual way: `gmtime_r()`, then the fields through "%04d-%02d-..."
+// `ii` steps 1 ms, so that a thousand calls in a row fall into the same second
+static int format_gmtime_prefix(int ii) {
+    long long ns = 1715949296000000000ll + ii * 1000000ll;
+    time_t second = (time_t)(ns / 1000000000);
+    struct tm tm;
+    gmtime_r(&second, &tm);
+    return pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ", tm.tm_year + 1900, tm.tm_mon + 1,
+        tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, (int)(ns % 1000000000 / 1000));
+}
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+
+
+// a long line pulled in UART_CHUNK-sized chunks, each into the next slot of `pBenchBuf` as if into the next DMA buffer
+#define UART_CHUNK 64
+static int render_chunked(const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    pico_fmt_state state;
+    pico_fmt_begin(&state, pFormat, vl);
+    size_t cbTotal = 0;
+    for (char *pChunk = pBenchBuf; state.pFormat; pChunk += UART_CHUNK) {
+        cbTotal += pico_fmt_next(&state, pChunk, UART_CHUNK);
+    }
+    va_end(vl);
+    return (int)cbTotal;
+}
+
+
+unsigned char pLogBuf[0x10000];
+pico_log_ring logRing;
+
+// the capture alone: the records are discarded whenever the ring fills up, rather than rendered
+static int capture_log_line(const char *pLogLine, int ii) {
+    int cbRecord = pico_log_capture(&logRing, pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3);
+    if (cbRecord < 0) {
+        logRing.tail = logRing.head;
+        cbRecord = pico_log_capture(&logRing, pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3);
+    }
+    return cbRecord;
+}
+
+
+#define ITERATIONS 200000
+#define REPETITIONS 7                   // the fastest repetition is reported, which filters out the scheduler noise
+
+// prints a CSV row: config, case, implementation, ns/call, bytes/call, cycles/byte
+// `ii` is the iteration number, for the arguments to vary from one call to the next
+#define BENCH(caseName, implName, ...) { \
+        double best = 0, bestCycles = 0; \
+        long long bytes = 0; \
+        for (int rep = 0; rep < REPETITIONS; rep++) { \
+            bytes = 0; \
+            double start = now_ns(), startCycles = now_cycles(); \
+            for (int ii = 0; ii < ITERATIONS; ii++) { \
+                bytes += __VA_ARGS__; \
+            } \
+            double elapsed = (now_ns() - start) / ITERATIONS, cycles = (now_cycles() - startCycles) / ITERATIONS; \
+            if (0 == rep || elapsed < best) { \
+                best = elapsed; \
+                bestCycles = cycles; \
+            } \
+        } \
+        g_sink += (int)bytes; \
+        double bytesPerCall = (double)bytes / ITERATIONS; \
+        printf("%s,%s,%s,%.1f,%.1f,", g_pConfig, caseName, implName, best, bytesPerCall); \
+        if (bestCycles > 0 && bytesPerCall > 0) { \
+            printf("%.2f", bestCycles / bytesPerCall); \
+        } \
+        printf("\n"); \
+    }
+
+// the chars rendered by one of the typed kernels into `pBenchBuf`: the typed kernel's row next to its format
+#define KERNEL_CHARS(kernel, ...) ((int)(kernel(pBenchBuf, pBenchBuf + sizeof(pBenchBuf), __VA_ARGS__) - pBenchBuf))
+
+// the same case through every implementation at hand
+#ifdef __RUN_COMPARISON_TESTS__
+#define BENCH_COMPARISONS(caseName, format, ...) \
+    BENCH(caseName, "mpaland", snprintf_(pBenchBuf, sizeof(pBenchBuf), format, __VA_ARGS__)); \
+    BENCH(caseName, "tinyprintf", tfp_snprintf(pBenchBuf, sizeof(pBenchBuf), format, __VA_ARGS__)); \
+    BENCH(caseName, "nanoprintf", npf_snprintf(pBenchBuf, sizeof(pBenchBuf), format, __VA_ARGS__));
+#else
+#define BENCH_COMPARISONS(caseName, format, ...)
+#endif // __RUN_COMPARISON_TESTS__
+
+#define BENCH_CASE(caseName, format, ...) \
+    BENCH(caseName, "picoprintf", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), format, __VA_ARGS__)); \
+    BENCH(caseName, "stdlib", snprintf(pBenchBuf, sizeof(pBenchBuf), format, __VA_ARGS__)); \
+    BENCH_COMPARISONS(caseName, format, __VA_ARGS__)
+
+
+// threads logging concurrently to the same file descriptor, on /dev/null for the syscalls rather than the disk to count
+#define LOG_THREADS 8
+int g_logFd;
+FILE *g_pLogFile;                       // on the same fd, fully buffered by stdio, which locks it on every call
+int g_logPolicy;
+
+static int log_pico_dprintf(const char *pLogLine, int ii) {
+    return pico_dprintf(g_logFd, pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3);
+}
+
+static int log_fprintf(const char *pLogLine, int ii) {
+    return fprintf(g_pLogFile, pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3);
+}
+
+static int log_dprintf(const char *pLogLine, int ii) {
+    return dprintf(g_logFd, pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3);
+}
+
+static int log_snprintf_write(const char *pLogLine, int ii) {
+    char pLine[128];
+    int len = snprintf(pLine, sizeof(pLine), pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3);
+    return (int)write(g_logFd, pLine, (size_t)len);
+}
+
+typedef struct {
+    int (*logFn)(const char *pLogLine, int ii);
+    const char *pLogLine;
+    int first;
+} log_thread;
+
+static void *log_lines(void *pArg) {
+    log_thread *pThread = (log_thread *)pArg;
+    pico_set_flush_policy(g_logPolicy);
+    for (int ii = pThread->first; ii < pThread->first + ITERATIONS / LOG_THREADS; ii++) {
+        pThread->logFn(pThread->pLogLine, ii);
+    }
+    pico_flush();
+    return NULL;
+}
+
+// the write syscalls of the process so far (Linux only: -1 elsewhere)
+static long long count_writes(void) {
+    long long cWrites = -1;
+    FILE *pIo = fopen("/proc/self/io", "r");
+    if (pIo) {
+        char pLine[64];
+        while (fgets(pLine, sizeof(pLine), pIo) && 1 != sscanf(pLine, "syscw: %lld", &cWrites));
+        fclose(pIo);
+    }
+    return cWrites;
+}
+
+// prints a CSV row like `BENCH()`, per line logged by `LOG_THREADS` threads at once, with the write syscalls per 1000 lines
+static void bench_threads(const char *implName, int (*logFn)(const char *, int), const char *pLogLine) {
+    double best = 0, bestCycles = 0;
+    long long cWrites = 0;
+    for (int rep = 0; rep < REPETITIONS; rep++) {
+        pthread_t pThreads[LOG_THREADS];
+        log_thread pArgs[LOG_THREADS];
+        long long startWrites = count_writes();
+        double start = now_ns(), startCycles = now_cycles();
+        for (int ii = 0; ii < LOG_THREADS; ii++) {
+            pArgs[ii] = (log_thread){ logFn, pLogLine, ii * (ITERATIONS / LOG_THREADS) };
+            pthread_create(&pThreads[ii], NULL, log_lines, &pArgs[ii]);
+        }
+        for (int ii = 0; ii < LOG_THREADS; ii++) {
+            pthread_join(pThreads[ii], NULL);
+        }
+        fflush(g_pLogFile);
+        double elapsed = (now_ns() - start) / ITERATIONS, cycles = (now_cycles() - startCycles) / ITERATIONS;
+        cWrites = count_writes() - startWrites;
+        if (0 == rep || elapsed < best) {
+            best = elapsed;
+            bestCycles = cycles;
+        }
+    }
+    double bytesPerCall = (double)snprintf(NULL, 0, pLogLine, "info", 255, ITERATIONS / 2, -ITERATIONS / 2, 42, ITERATIONS / 16);
+    printf("%s,threaded log,%s (%.1f writes per 1000 lines),%.1f,%.1f,", g_pConfig, implName, cWrites * 1000.0 / ITERATIONS, best, bytesPerCall);
+    if (bestCycles > 0) {
+        printf("%.2f", bestCycles / bytesPerCall);
+    }
+    printf("\n");
+}
+
+int main(int argc, const char **argv) {
+    const char *pFilter = argc > 1 ? argv[1] : NULL;    // runs only the cases whose names contain this
+    const char *pLogLine = "[%s] temperature sensor #%d reports %d, %d and %d at tick %u";
+    const char *pLongString = "a rather long string, for the copying rather than the parsing to dominate the time";
+    pico_compiled_fmt compiled;
+    pico_format_op pOps[8];
+    if (pico_format_compile(pLogLine, &compiled, pOps, sizeof(pOps) / sizeof(pOps[0])) < 0) {
+        printf("failed to compile \"%s\"\n", pLogLine);
+        return 1;
+    }
+
+    printf("config,case,impl,ns_per_call,bytes_per_call,cycles_per_byte\n");
+    #define SELECTED(caseName) (NULL == pFilter || strstr(caseName, pFilter))
+
+    if (SELECTED("%d small")) {
+        BENCH_CASE("%d small", "%d", ii & 0xff);
+        BENCH("%d small", "pico_u32toa()", KERNEL_CHARS(pico_u32toa, ii & 0xff));
+    }
+    if (SELECTED("%d large")) {
+        BENCH_CASE("%d large", "%d", (int)(ii * 2654435761u));
+        BENCH("%d large", "pico_i64toa()", KERNEL_CHARS(pico_i64toa, (int)(ii * 2654435761u)));
+    }
+    if (SELECTED("%lld")) {
+        BENCH_CASE("%lld", "%lld", (long long)ii * -2654435761987ll);
+        BENCH("%lld", "pico_i64toa()", KERNEL_CHARS(pico_i64toa, (long long)ii * -2654435761987ll));
+    }
+#ifdef PICOFORMAT_HANDLE_HEX
+    if (SELECTED("%x")) {
+        BENCH_CASE("%x", "%x", ii * 2654435761u);
+    }
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (SELECTED("%08x")) {
+        BENCH_CASE("%08x", "%08x", ii * 2654435761u);
+    }
+    if (SELECTED("%016llx")) {
+        BENCH_CASE("%016llx", "%016llx", ii * 0x9e3779b97f4a7c15ull);
+        BENCH("%016llx", "pico_xtoa()", KERNEL_CHARS(pico_xtoa, ii * 0x9e3779b97f4a7c15ull, 16, 0));
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+#endif // PICOFORMAT_HANDLE_HEX
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+    for (size_t ii = 0; ii < sizeof(pPayload); ii++) {
+        pPayload[ii] = (unsigned char)(ii * 37 + 11);
+    }
+    if (SELECTED("hexdump 64B")) {
+        BENCH("hexdump 64B", "picoprintf %*H", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "%*H", (int)sizeof(pPayload), pPayload));
+        BENCH("hexdump 64B", "pico_hexdump()", pico_hexdump(pBenchBuf, sizeof(pBenchBuf), pPayload, sizeof(pPayload), 0));
+        BENCH("hexdump 64B", "stdlib %02x per byte", snprintf_hexdump(pBenchBuf, sizeof(pBenchBuf), pPayload, sizeof(pPayload)));
+    }
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+#ifdef PICOFORMAT_HANDLE_ARRAYS
+    for (size_t ii = 0; ii < ARRAY_SIZE; ii++) {    // samples around zero, counters of all magnitudes
+        pSamples[ii] = (int32_t)(ii * 2654435761u) >> (ii % 24);
+        pCounters[ii] = (ii * 0x9e3779b97f4a7c15ull) >> (16 + ii % 48);
+    }
+    if (SELECTED("i32 array")) {
+        BENCH("i32 array", "pico_format_i32_array()", format_i32_array());
+        BENCH("i32 array", "picoprintf %d per value", SCALAR_ARRAY_LOOP(pico_snprintf, "%d", pSamples, int));
+        BENCH("i32 array", "stdlib %d per value", SCALAR_ARRAY_LOOP(snprintf, "%d", pSamples, int));
+    }
+    if (SELECTED("u64 array")) {
+        BENCH("u64 array", "pico_format_u64_array()", format_u64_array());
+        BENCH("u64 array", "picoprintf %llu per value", SCALAR_ARRAY_LOOP(pico_snprintf, "%llu", pCounters, unsigned long long));
+        BENCH("u64 array", "stdlib %llu per value", SCALAR_ARRAY_LOOP(snprintf, "%llu", pCounters, unsigned long long));
+    }
+#endif // PICOFORMAT_HANDLE_ARRAYS
+    if (SELECTED("parse short")) {
+        BENCH("parse short", "pico_strtoi32()", PICO_PARSED_CHARS(pico_strtoi32, g_pShortIntegers, 10));
+        BENCH("parse short", "stdlib strtol()", PARSED_CHARS(strtol, g_pShortIntegers, 10));
+    }
+    if (SELECTED("parse long")) {
+        BENCH("parse long", "pico_strtou64()", PICO_PARSED_CHARS(pico_strtou64, g_pLongIntegers, 10));
+        BENCH("parse long", "stdlib strtoull()", PARSED_CHARS(strtoull, g_pLongIntegers, 10));
+    }
+    if (SELECTED("parse hex")) {
+        BENCH("parse hex", "pico_strtou64()", PICO_PARSED_CHARS(pico_strtou64, g_pHexIntegers, 16));
+        BENCH("parse hex", "stdlib strtoull()", PARSED_CHARS(strtoull, g_pHexIntegers, 16));
+    }
+    if (SELECTED("parse readings")) {
+        BENCH("parse readings", "pico_strtod()", FLOAT_PARSED_CHARS(pico_strtod, g_pReadings, const char));
+        BENCH("parse readings", "stdlib strtod()", FLOAT_PARSED_CHARS(strtod, g_pReadings, char));
+        BENCH("parse readings", "pico_strtof()", FLOAT_PARSED_CHARS(pico_strtof, g_pReadings, const char));
+        BENCH("parse readings", "stdlib strtof()", FLOAT_PARSED_CHARS(strtof, g_pReadings, char));
+    }
+    if (SELECTED("parse doubles")) {
+        BENCH("parse doubles", "pico_strtod()", FLOAT_PARSED_CHARS(pico_strtod, g_pPreciseDoubles, const char));
+        BENCH("parse doubles", "stdlib strtod()", FLOAT_PARSED_CHARS(strtod, g_pPreciseDoubles, char));
+    }
+    for (size_t ii = 0, cbInts = 0, cbReadings = 0; ii < LIST_SIZE; ii++) {   // counters of all magnitudes, readings
+        cbInts += snprintf(pIntegerRow + cbInts, sizeof(pIntegerRow) - cbInts, ii ? ",%lld" : "%lld", (long long)(ii * 2654435761u) >> (ii % 24));
+        cbReadings += snprintf(pReadingRow + cbReadings, sizeof(pReadingRow) - cbReadings, ii ? ", %.2f" : "%.2f", (int)(ii * 2654435761u % 200000) / 100. - 1000);
+    }
+    if (SELECTED("i64 list")) {
+        BENCH("i64 list", "pico_parse_i64_list()", parse_integer_row());
+        BENCH("i64 list", "stdlib strtoll() per value", SCALAR_LIST_LOOP(strtoll, pIntegerRow, pParsedIntegers, 10));
+    }
+    if (SELECTED("f64 list")) {
+        BENCH("f64 list", "pico_parse_f64_list()", parse_reading_row());
+        BENCH("f64 list", "stdlib strtod() per value", SCALAR_LIST_LOOP(strtod, pReadingRow, pParsedDoubles));
+    }
+    if (SELECTED("sscanf ints")) {
+        int id, seq, end;
+        char pName[16];
+        const char *pLine = "id=42 name=probe7 seq=123456";
+        BENCH("sscanf ints", "pico_sscanf()", (pico_sscanf(pLine, "id=%d name=%15s seq=%d%n", &id, pName, &seq, &end), end));
+        BENCH("sscanf ints", "stdlib sscanf()", (sscanf(pLine, "id=%d name=%15s seq=%d%n", &id, pName, &seq, &end), end));
+    }
+#ifdef PICOFORMAT_HANDLE_FLOATS
+    if (SELECTED("sscanf floats")) {
+        float temp, humidity;
+        int end;
+        const char *pLine = "temp=23.57 rh=41.2";
+        BENCH("sscanf floats", "pico_sscanf()", (pico_sscanf(pLine, "temp=%f rh=%f%n", &temp, &humidity, &end), end));
+        BENCH("sscanf floats", "stdlib sscanf()", (sscanf(pLine, "temp=%f rh=%f%n", &temp, &humidity, &end), end));
+    }
+#endif // PICOFORMAT_HANDLE_FLOATS
+    if (SELECTED("%s short")) {
+        BENCH_CASE("%s short", "%s", g_pShortString);
+    }
+    if (SELECTED("%s long")) {
+        BENCH_CASE("%s long", "%s", pLongString + (ii & 7));
+    }
+    if (SELECTED("%.*s")) {
+        BENCH_CASE("%.*s", "%.*s", 40, pLongString + (ii & 7));
+    }
+    if (SELECTED("literal")) {          // mostly text between the specifiers: the copying of the format dominates
+        BENCH_CASE("literal", "the device at the end of the second bus reports a status of %d after the reset sequence\n", ii & 0xff);
+    }
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (SELECTED("width/fill")) {
+        BENCH_CASE("width/fill", "%08d|%-8s|%5d", ii, "left", ii & 0x3ff);
+    }
+    if (SELECTED("wide fill")) {
+        BENCH_CASE("wide fill", "%-40s|%40d", g_pShortString, ii);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+    if (SELECTED("%Q")) {               // a Q16.16 reading of +-32768: as is, or converted to a double for "%f"
+        #define Q16_READING(ii) ((int)((ii) * 2654435761u) >> 8)
+        BENCH("%Q", "picoprintf %.3Q16", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "%.3Q16", Q16_READING(ii)));
+#ifdef PICOFORMAT_HANDLE_FLOATS
+        BENCH("%Q", "picoprintf %.3f", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "%.3f", Q16_READING(ii) / 65536.));
+#endif // PICOFORMAT_HANDLE_FLOATS
+        BENCH("%Q", "stdlib %.3f", snprintf(pBenchBuf, sizeof(pBenchBuf), "%.3f", Q16_READING(ii) / 65536.));
+    }
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+#ifdef PICOFORMAT_HANDLE_FLOATS
+    if (SELECTED("%f")) {
+        BENCH_CASE("%f", "%f", ii * 1.37);
+    }
+    if (SELECTED("%f tiny")) {
+        BENCH_CASE("%f tiny", "%f", ii * 1.37e-9);
+    }
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+    if (SELECTED("%e")) {
+        BENCH_CASE("%e", "%e", ii * 1.37e100);
+    }
+    if (SELECTED("%g")) {
+        BENCH_CASE("%g", "%g", ii * 1.37);
+    }
+    if (SELECTED("%r")) {               // shortest round-trip: the closest stdlib counterpart is "%.17g"
+        BENCH("%r", "picoprintf", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "%r", ii * 1.37));
+        BENCH("%r", "stdlib %.17g", snprintf(pBenchBuf, sizeof(pBenchBuf), "%.17g", ii * 1.37));
+    }
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+#endif // PICOFORMAT_HANDLE_FLOATS
+    if (SELECTED("log line")) {
+        BENCH_CASE("log line", pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3);
+        BENCH("log line", "picoprintf compiled", pico_format_render(&compiled, pBenchBuf, sizeof(pBenchBuf), "info", ii & 0xff, ii, -ii, 42, ii >> 3));
+        BENCH("log line", "picoprintf measure", pico_measure(pLogLine, "info", ii & 0xff, ii, -ii, 42, ii >> 3));
+        pico_log_init(&logRing, pLogBuf, sizeof(pLogBuf), 0);
+        BENCH("log line", "pico_log_capture() record", capture_log_line(pLogLine, ii));
+    }
+    if (SELECTED("chunked line")) {
+        const char *pLong = "[%s] sensor #%d: %d, %d, %d, %d at tick %u; %s: %s";
+        const char *pNote = "calibration pending, see the maintenance log";
+        BENCH("chunked line", "pico_fmt_next() by 64", render_chunked(pLong, "info", ii & 0xff, ii, -ii, 42, ii >> 3, ii, "note", pNote));
+        BENCH("chunked line", "picoprintf whole", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), pLong, "info", ii & 0xff, ii, -ii, 42, ii >> 3, ii, "note", pNote));
+    }
+    if (SELECTED("record assembly")) {
+        BENCH("record assembly", "pico_buf", assemble_buf(ii));
+        BENCH("record assembly", "picoprintf by offsets", assemble_offsets(ii));
+        BENCH("record assembly", "picoprintf + strlen()", assemble_strlen(ii));
+    }
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+    if (SELECTED("timestamp")) {
+        BENCH("timestamp", "picoprintf %lT", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "%lT", 1715949296000000000ll + ii * 1000000ll));
+        BENCH("timestamp", "picoprintf %lT (a second each)", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "%lT", 1715949296000000000ll + ii * 1000000000ll));
+        BENCH("timestamp", "gmtime_r() + picoprintf", format_gmtime_prefix(ii));
+    }
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+    if (SELECTED("ipv4 peer")) {
+        pico_register_conversion('I', convert_ipv4);
+        BENCH("ipv4 peer", "picoprintf %I", pico_snprintf(pBenchBuf, sizeof(pBenchBuf), "peer %I:%d", ii * 2654435761u, ii & 0xffff));
+        BENCH("ipv4 peer", "picoprintf %s of a temporary", format_ipv4_temporary(ii * 2654435761u, ii & 0xffff));
+    }
+#endif // PICOFORMAT_HANDLE_CUSTOM
+    if (SELECTED("threaded log")) {
+        const char *pLogLineNl = "[%s] temperature sensor #%d reports %d, %d and %d at tick %u\n";
+        g_logFd = open("/dev/null", O_WRONLY);
+        g_pLogFile = fdopen(g_logFd, "w");
+        g_logPolicy = PICOIO_FLUSH_FULL;
+        bench_threads("pico_dprintf() full", log_pico_dprintf, pLogLineNl);
+        g_logPolicy = PICOIO_FLUSH_LINE;
+        bench_threads("pico_dprintf() line", log_pico_dprintf, pLogLineNl);
+        bench_threads("stdlib fprintf() full", log_fprintf, pLogLineNl);
+        setvbuf(g_pLogFile, NULL, _IOLBF, BUFSIZ);
+        bench_threads("stdlib fprintf() line", log_fprintf, pLogLineNl);
+        bench_threads("stdlib dprintf()", log_dprintf, pLogLineNl);
+        bench_threads("stdlib snprintf() + write()", log_snprintf_write, pLogLineNl);
+        fclose(g_pLogFile);
+    }
+
+    return 0;
+}
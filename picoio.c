@@ -0,0 +1,163 @@
+#include "picoio.h"
+#include "picobool.h"
+
+#include <errno.h>      // EINTR
+#include <pthread.h>    // pthread_key_create(): the flush at the exit of a thread
+#include <stdlib.h>     // atexit(): the flush at the exit of the process
+#include <string.h>     // memchr(), memmove()
+#include <unistd.h>     // write(), STDOUT_FILENO
+
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define THREAD_LOCAL __thread
+#else // __STDC_VERSION__
+#error "picoio.c requires thread-local storage: C11, or the __thread of gcc and clang"
+#endif // __STDC_VERSION__
+
+typedef struct {
+    size_t cbPending;               // the output not written yet, at the start of `pBuf`
+    int fd;                         // where the pending output goes
+    int policy;                     // `PICOIO_FLUSH_*`: all zeros is the default state, so the buffers live in .tbss
+    bool hooked;                    // the exit of the thread flushes this buffer
+    char pBuf[PICOIO_BUFFER_SIZE];
+} thread_buffer;
+
+static THREAD_LOCAL thread_buffer g_thread;
+
+static pthread_key_t g_exitKey;
+static pthread_once_t g_hooksOnce = PTHREAD_ONCE_INIT;
+
+
+// writes all of `pSrc`, resuming after the partial writes and the interrupts; returns false on an error
+static bool write_all(int fd, const char *pSrc, size_t cbSrc) {
+    while (cbSrc > 0) {
+        ssize_t cbWritten = write(fd, pSrc, cbSrc);
+        if (cbWritten <= 0) {
+            if (cbWritten < 0 && EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        pSrc += cbWritten;
+        cbSrc -= (size_t)cbWritten;
+    }
+    return true;
+}
+
+
+// writes the pending output of `pThread`, which is dropped if that fails
+static bool write_pending(thread_buffer *pThread) {
+    if (!pThread->cbPending) {
+        return true;
+    }
+    size_t cbPending = pThread->cbPending;
+    pThread->cbPending = 0;
+    return write_all(pThread->fd, pThread->pBuf, cbPending);
+}
+
+
+static void flush_at_thread_exit(void *pThread) {
+    write_pending((thread_buffer *)pThread);
+}
+
+
+static void flush_at_exit(void) {
+    write_pending(&g_thread);
+}
+
+
+static void install_hooks(void) {
+    pthread_key_create(&g_exitKey, flush_at_thread_exit);
+    atexit(flush_at_exit);
+}
+
+
+// the buffer of the calling thread, hooked to its exit on the first call
+static thread_buffer *get_thread_buffer(void) {
+    thread_buffer *pThread = &g_thread;
+    if (!pThread->hooked) {
+        pthread_once(&g_hooksOnce, install_hooks);
+        pthread_setspecific(g_exitKey, pThread);
+        pThread->hooked = true;
+    }
+    return pThread;
+}
+
+
+int pico_set_flush_policy(int policy) {
+    int previous = g_thread.policy;
+    g_thread.policy = policy;
+    return previous;
+}
+
+
+int pico_vdprintf(int fd, const char *pFormat, va_list vl) {
+    thread_buffer *pThread = get_thread_buffer();
+    bool ok = true;
+    if (fd != pThread->fd) {
+        ok = write_pending(pThread);
+        pThread->fd = fd;
+    }
+
+    // pulled straight after the pending output, which is kept if the call fits the rest of the buffer
+    pico_fmt_state state;
+    pico_fmt_begin(&state, pFormat, vl);
+    char *pDest = pThread->pBuf + pThread->cbPending;
+    size_t cbCall = pico_fmt_next(&state, pDest, sizeof(pThread->pBuf) - pThread->cbPending);
+    bool newline = NULL != memchr(pDest, '\n', cbCall);
+    if (!state.pFormat) {
+        pThread->cbPending += cbCall;
+    } else {
+        // the pending output is written, and the call goes on from the start of the buffer: it stays there if it fits,
+        // else it streams through it, a full buffer per write
+        ok = write_pending(pThread) && ok;
+        memmove(pThread->pBuf, pDest, cbCall);
+        size_t cbFilled = cbCall;
+        while (state.pFormat) {
+            if (sizeof(pThread->pBuf) == cbFilled) {
+                ok = write_all(fd, pThread->pBuf, cbFilled) && ok;
+                cbFilled = 0;
+            }
+            size_t cbChunk = pico_fmt_next(&state, pThread->pBuf + cbFilled, sizeof(pThread->pBuf) - cbFilled);
+            newline = newline || NULL != memchr(pThread->pBuf + cbFilled, '\n', cbChunk);
+            cbFilled += cbChunk;
+            cbCall += cbChunk;
+        }
+        pThread->cbPending = cbFilled;
+    }
+
+    if (PICOIO_FLUSH_EACH == pThread->policy || (PICOIO_FLUSH_LINE == pThread->policy && newline)) {
+        ok = write_pending(pThread) && ok;
+    }
+    return ok ? (int)cbCall : -1;
+}
+
+
+int pico_dprintf(int fd, const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    int result = pico_vdprintf(fd, pFormat, vl);
+    va_end(vl);
+    return result;
+}
+
+
+int pico_vprintf(const char *pFormat, va_list vl) {
+    return pico_vdprintf(STDOUT_FILENO, pFormat, vl);
+}
+
+
+int pico_printf(const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    int result = pico_vdprintf(STDOUT_FILENO, pFormat, vl);
+    va_end(vl);
+    return result;
+}
+
+
+int pico_flush(void) {
+    return write_pending(&g_thread) ? 0 : -1;
+}
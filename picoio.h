@@ -0,0 +1,49 @@
+#ifndef __picoio_h_INCLUDED__
+#define __picoio_h_INCLUDED__
+
+// buffered output to the file descriptors of POSIX: `pico_printf()` and `pico_dprintf()` render straight into a buffer
+// of the calling thread, through the same kernels as `pico_snprintf()`, and write it with as few syscalls as the flush
+// policy allows: no lock is taken, as the threads never share a buffer, and every write carries whole calls, so the
+// lines of different threads do not interleave (as long as a write fits `PIPE_BUF` on a pipe, or the file is `O_APPEND`)
+// the pending output of a thread is written when the thread exits, and that of the main thread at `exit()`; the other
+// threads still running at `exit()` lose theirs unless they call `pico_flush()` first
+// e.g. `#define FORMAT_ERROR_DELEGATE(__message, __arg) pico_dprintf(2, __message "\n", __arg)` (before including
+// picoprintf.h) reports the format errors without stdio
+
+#include "picoprintf.h"
+
+#include <stdarg.h>
+
+// each thread has a buffer of this size, in thread-local storage: a call whose output does not fit the rest of it is
+// written after the pending output, from the start of the buffer, and one that does not fit a whole buffer streams through it
+#ifndef PICOIO_BUFFER_SIZE
+    #define PICOIO_BUFFER_SIZE 4096
+#endif // PICOIO_BUFFER_SIZE
+
+// when the pending output of a thread is written, besides when the buffer is full, when the thread switches to another
+// file descriptor (so the output to each of them keeps its order), and on `pico_flush()`
+#define PICOIO_FLUSH_LINE 0 // after every call that outputs a '\n', like stdio on a terminal: the default
+#define PICOIO_FLUSH_FULL 1 // only then: the fewest syscalls, and the output of a thread stays pending until it fills a buffer
+#define PICOIO_FLUSH_EACH 2 // after every call: unbuffered, but still a single syscall per call
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// sets the flush policy of the calling thread, and returns the previous one
+int pico_set_flush_policy(int policy);
+
+// return the number of chars output, like `printf()`, or -1 if a write failed (the pending output is dropped then)
+int pico_printf(const char *pFormat, ...);
+int pico_vprintf(const char *pFormat, va_list vl);
+int pico_dprintf(int fd, const char *pFormat, ...);
+int pico_vdprintf(int fd, const char *pFormat, va_list vl);
+
+// writes the pending output of the calling thread; returns 0, or -1 if a write failed
+int pico_flush(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __picoio_h_INCLUDED__
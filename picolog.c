@@ -0,0 +1,397 @@
+#include "picolog.h"
+#include "picobool.h"
+
+#include <string.h> // memcpy()
+
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+#include <time.h>   // struct timespec, of the "%T" arguments
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+
+
+#if PICOLOG_MAX_RECORD > 0xffff || PICOLOG_MAX_RECORD < 2 * PICOLOG_HEADER_SIZE
+#error "PICOLOG_MAX_RECORD must fit the uint16 size of the wire format"
+#endif // PICOLOG_MAX_RECORD
+
+// the ring cursors are shared between the threads: the records are published with release, and read with acquire
+#if defined(__GNUC__)
+#define LOAD_ACQUIRE(pVal) __atomic_load_n(pVal, __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(pVal, val) __atomic_store_n(pVal, val, __ATOMIC_RELEASE)
+#define COMPARE_EXCHANGE(pVal, pExpected, desired) __atomic_compare_exchange_n(pVal, pExpected, desired, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)
+#define FETCH_INC(pVal) __atomic_fetch_add(pVal, 1, __ATOMIC_RELAXED)
+#else // __GNUC__
+#error "picolog.c requires the __atomic builtins of gcc or clang"
+#endif // __GNUC__
+
+// using #define over `inline` for enabling porting to old C
+#if !defined(MIN)
+#define MIN(left, right) (((left) < (right)) ? (left) : (right))
+#endif
+
+// strings and hex dumps leave this much room in the record for the numbers that follow them
+#define RECORD_TAIL_ROOM 32
+
+
+// the wire format is little-endian: on little-endian targets, the compilers merge these into plain loads and stores
+static unsigned char *put_u16(unsigned char *pDest, uint32_t val) {
+    pDest[0] = (unsigned char)val;
+    pDest[1] = (unsigned char)(val >> 8);
+    return pDest + 2;
+}
+
+
+static unsigned char *put_u32(unsigned char *pDest, uint32_t val) {
+    for (int ii = 0; ii < 4; ii++) {
+        pDest[ii] = (unsigned char)(val >> 8 * ii);
+    }
+    return pDest + 4;
+}
+
+
+static unsigned char *put_u64(unsigned char *pDest, uint64_t val) {
+    for (int ii = 0; ii < 8; ii++) {
+        pDest[ii] = (unsigned char)(val >> 8 * ii);
+    }
+    return pDest + 8;
+}
+
+
+static uint32_t get_u16(const unsigned char *pSrc) {
+    return pSrc[0] | (uint32_t)pSrc[1] << 8;
+}
+
+
+static uint32_t get_u32(const unsigned char *pSrc) {
+    uint32_t val = 0;
+    for (int ii = 0; ii < 4; ii++) {
+        val |= (uint32_t)pSrc[ii] << 8 * ii;
+    }
+    return val;
+}
+
+
+static uint64_t get_u64(const unsigned char *pSrc) {
+    uint64_t val = 0;
+    for (int ii = 0; ii < 8; ii++) {
+        val |= (uint64_t)pSrc[ii] << 8 * ii;
+    }
+    return val;
+}
+
+
+// copies into the ring at the free-running position `pos`, wrapping around its end
+static void ring_write(pico_log_ring *pRing, uint32_t pos, const unsigned char *pSrc, uint32_t cbSrc) {
+    uint32_t offset = pos & pRing->cbMask;
+    uint32_t cbFirst = MIN(cbSrc, pRing->cbMask + 1 - offset);
+    memcpy(pRing->pBuf + offset, pSrc, cbFirst);
+    memcpy(pRing->pBuf, pSrc + cbFirst, cbSrc - cbFirst);
+}
+
+
+static void ring_read(const pico_log_ring *pRing, uint32_t pos, unsigned char *pDest, uint32_t cbDest) {
+    uint32_t offset = pos & pRing->cbMask;
+    uint32_t cbFirst = MIN(cbDest, pRing->cbMask + 1 - offset);
+    memcpy(pDest, pRing->pBuf + offset, cbFirst);
+    memcpy(pDest + cbFirst, pRing->pBuf, cbDest - cbFirst);
+}
+
+
+int pico_log_init(pico_log_ring *pRing, void *pBuf, size_t cbBuf, unsigned flags) {
+    if (cbBuf < PICOLOG_MAX_RECORD || 0 != (cbBuf & (cbBuf - 1)) || cbBuf > 0x80000000u) {
+        return -1;
+    }
+    pico_log_ring empty = {0};
+    *pRing = empty;
+    pRing->pBuf = (unsigned char *)pBuf;
+    pRing->cbMask = (uint32_t)(cbBuf - 1);
+    pRing->flags = flags;
+    return 0;
+}
+
+
+// publishes a record: a single producer owns `head`, while the multiple producers reserve their spans on `reserved` first
+static int ring_commit(pico_log_ring *pRing, const unsigned char *pRecord, uint32_t cbRecord) {
+    uint32_t cbRing = pRing->cbMask + 1;
+    uint32_t start;
+    if (pRing->flags & PICO_LOG_MULTI_PRODUCER) {
+        start = LOAD_ACQUIRE(&pRing->reserved);
+        do {
+            if (cbRecord > cbRing - (start - LOAD_ACQUIRE(&pRing->tail))) {
+                FETCH_INC(&pRing->cDropped);
+                return -1;
+            }
+        } while (!COMPARE_EXCHANGE(&pRing->reserved, &start, start + cbRecord));
+    } else {
+        start = pRing->head;
+        if (cbRecord > cbRing - (start - LOAD_ACQUIRE(&pRing->tail))) {
+            FETCH_INC(&pRing->cDropped);
+            return -1;
+        }
+    }
+    ring_write(pRing, start, pRecord, cbRecord);
+    if (pRing->flags & PICO_LOG_MULTI_PRODUCER) {
+        while (LOAD_ACQUIRE(&pRing->head) != start);    // the records reserved before this one are published first
+    }
+    STORE_RELEASE(&pRing->head, start + cbRecord);
+    return (int)cbRecord;
+}
+
+
+int pico_log_vcapture(pico_log_ring *pRing, const char *pFormat, va_list vl) {
+    unsigned char pRecord[PICOLOG_MAX_RECORD];
+    unsigned char *pArg = pRecord + PICOLOG_HEADER_SIZE;
+    const unsigned char *pRecordEnd = pRecord + sizeof(pRecord);
+    const char *pFormatStart = pFormat;
+    va_list vlCopy;                         // `va_arg()` is only portable on a local `va_list`
+    va_copy(vlCopy, vl);
+    while (*pFormat) {
+        pico_format_op op;
+        pFormat = pico_format_next(pFormat, &op);
+        pico_format_spec *pSpec = &op.spec;
+        if ('\0' == pSpec->format) {
+            continue;
+        }
+        if (pRecordEnd - pArg < 16) {       // the '*' width and precision, and a 64-bit value
+            va_end(vlCopy);
+            FETCH_INC(&pRing->cDropped);
+            return -1;
+        }
+        if (pSpec->flags.whole_from_arg) {
+            pSpec->whole_chars = va_arg(vlCopy, int);
+            pArg = put_u32(pArg, (uint32_t)pSpec->whole_chars);
+        }
+        if (pSpec->flags.decimal_from_arg) {
+            pSpec->decimal_chars = va_arg(vlCopy, int);
+            pArg = put_u32(pArg, (uint32_t)pSpec->decimal_chars);
+        }
+        size_t cbRoom = pRecordEnd - pArg - 2;
+        cbRoom = cbRoom > RECORD_TAIL_ROOM ? cbRoom - RECORD_TAIL_ROOM : 0;
+        switch (pSpec->format) {
+        case 's': {         // the chars up to the precision: never a char past it is read
+            const char *pStr = va_arg(vlCopy, const char *);
+            size_t cbMax = pSpec->decimal_chars >= 0 ? MIN(cbRoom, (size_t)pSpec->decimal_chars) : cbRoom;
+            size_t len = 0;
+            for (; len < cbMax && pStr[len]; len++);
+            pArg = put_u16(pArg, (uint32_t)len);
+            memcpy(pArg, pStr, len);
+            pArg += len;
+            break;
+        }
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+        case 'H': {         // the bytes themselves: the pointer may not be valid by the time the record is rendered
+            const void *pData = va_arg(vlCopy, const void *);
+            size_t len = pSpec->whole_chars > 0 ? MIN(cbRoom, (size_t)pSpec->whole_chars) : 0;
+            pArg = put_u16(pArg, (uint32_t)len);
+            memcpy(pArg, pData, len);
+            pArg += len;
+            break;
+        }
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+        case 'c':           // an `int` with or without 'l', as `render_spec()` reads it
+            pArg = put_u32(pArg, va_arg(vlCopy, unsigned));
+            break;
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
+        case 'b':
+#endif // defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_HEX)
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+        case 'Q':
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+        case 'd':
+        case 'i':
+            if (pSpec->flags.treat_as_long) {
+                pArg = put_u64(pArg, va_arg(vlCopy, unsigned long long int));
+            } else {
+                pArg = put_u32(pArg, va_arg(vlCopy, unsigned));
+            }
+            break;
+#ifdef PICOFORMAT_HANDLE_FLOATS
+        case 'f': case 'F':
+        case 'e': case 'E':
+        case 'g': case 'G':
+        case 'r': {
+            union { double val; uint64_t bits; } convert = { va_arg(vlCopy, double) };
+            pArg = put_u64(pArg, convert.bits);
+            break;
+        }
+#endif // PICOFORMAT_HANDLE_FLOATS
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+        case 'T':           // the nanoseconds since the epoch, of either form: the `struct timespec` may be gone by the rendering
+            if (pSpec->flags.treat_as_long) {
+                pArg = put_u64(pArg, va_arg(vlCopy, unsigned long long int));
+            } else {
+                const struct timespec *pTime = va_arg(vlCopy, const struct timespec *);
+                pArg = put_u64(pArg, (uint64_t)((long long)pTime->tv_sec * 1000000000 + pTime->tv_nsec));
+            }
+            break;
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+        default:            // a registered conversion: its arguments are opaque to the ring, so they cannot be captured
+            va_end(vlCopy);
+            return -1;
+#endif // PICOFORMAT_HANDLE_CUSTOM
+        }
+    }
+    va_end(vlCopy);
+
+    uint32_t cbRecord = (uint32_t)(pArg - pRecord);
+    pArg = put_u16(pRecord, cbRecord);
+    *pArg++ = PICOLOG_VERSION;
+    *pArg++ = (unsigned char)sizeof(void *);
+    put_u64(pArg, (uint64_t)(uintptr_t)pFormatStart);
+    return ring_commit(pRing, pRecord, cbRecord);
+}
+
+
+int pico_log_capture(pico_log_ring *pRing, const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    int result = pico_log_vcapture(pRing, pFormat, vl);
+    va_end(vl);
+    return result;
+}
+
+
+// renders a record through the kernels of picoprintf.c, the arguments read from the record instead of a `va_list`
+// a record that runs out of arguments (e.g. decoded offline with a wrong format) stops the rendering
+static void replay(pico_out *pOut, const unsigned char *pRecord, const char *pFormat) {
+    const unsigned char *pArg = pRecord + PICOLOG_HEADER_SIZE;
+    const unsigned char *pArgsEnd = pRecord + get_u16(pRecord);
+    #define HAS_ARG(cbArg) ((size_t)(pArgsEnd - pArg) >= (size_t)(cbArg))
+    while (*pFormat) {
+        pico_format_op op;
+        pFormat = pico_format_next(pFormat, &op);
+        pico_emit_literal(pOut, op.pLiteral, op.cbLiteral);
+        pico_format_spec *pSpec = &op.spec;
+        if ('\0' == pSpec->format) {
+            continue;
+        }
+        if (pSpec->flags.whole_from_arg) {
+            if (!HAS_ARG(4)) {
+                return;
+            }
+            pSpec->whole_chars = (int32_t)get_u32(pArg);
+            pArg += 4;
+        }
+        if (pSpec->flags.decimal_from_arg) {
+            if (!HAS_ARG(4)) {
+                return;
+            }
+            pSpec->decimal_chars = (int32_t)get_u32(pArg);
+            pArg += 4;
+        }
+        size_t cbArg = pSpec->flags.treat_as_long ? 8 : 4;
+        switch (pSpec->format) {
+        case 's':           // the length is the precision: the chars in the record are not null-terminated
+            if (!HAS_ARG(2) || !HAS_ARG(2 + get_u16(pArg))) {
+                return;
+            }
+            pSpec->decimal_chars = (int)get_u16(pArg);
+            pico_emit_string(pOut, pSpec, (const char *)pArg + 2);
+            pArg += 2 + pSpec->decimal_chars;
+            break;
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+        case 'H':
+            if (!HAS_ARG(2) || !HAS_ARG(2 + get_u16(pArg))) {
+                return;
+            }
+            pSpec->whole_chars = (int)get_u16(pArg);
+            pico_emit_hexdump(pOut, pSpec, pArg + 2);
+            pArg += 2 + pSpec->whole_chars;
+            break;
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+        case 'c':
+            if (!HAS_ARG(4)) {
+                return;
+            }
+            pico_emit_char(pOut, pSpec, (int)get_u32(pArg));
+            pArg += 4;
+            break;
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
+        case 'b':
+            if (!HAS_ARG(cbArg)) {
+                return;
+            }
+            pico_emit_radix(pOut, pSpec, 8 == cbArg ? get_u64(pArg) : get_u32(pArg));
+            pArg += cbArg;
+            break;
+#endif // defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_HEX)
+        case 'd':
+        case 'i':
+            if (!HAS_ARG(cbArg)) {
+                return;
+            }
+            if (8 == cbArg) {
+                pico_emit_decimal(pOut, pSpec, get_u64(pArg));
+            } else if (pSpec->flags.treat_as_unsigned) {
+                pico_emit_decimal(pOut, pSpec, get_u32(pArg));
+            } else {
+                pico_emit_decimal(pOut, pSpec, (unsigned long long int)(long long int)(int32_t)get_u32(pArg));
+            }
+            pArg += cbArg;
+            break;
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+        case 'Q':
+            if (!HAS_ARG(cbArg)) {
+                return;
+            }
+            pico_emit_fixed(pOut, pSpec, 8 == cbArg ? get_u64(pArg) : (unsigned long long int)(long long int)(int32_t)get_u32(pArg));
+            pArg += cbArg;
+            break;
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+#ifdef PICOFORMAT_HANDLE_FLOATS
+        case 'f': case 'F':
+        case 'e': case 'E':
+        case 'g': case 'G':
+        case 'r': {
+            if (!HAS_ARG(8)) {
+                return;
+            }
+            union { uint64_t bits; double val; } convert = { get_u64(pArg) };
+            pico_emit_double(pOut, pSpec, convert.val);
+            pArg += 8;
+            break;
+        }
+#endif // PICOFORMAT_HANDLE_FLOATS
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+        case 'T':
+            if (!HAS_ARG(8)) {
+                return;
+            }
+            pico_emit_timestamp(pOut, pSpec, (long long)get_u64(pArg));
+            pArg += 8;
+            break;
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+        }
+    }
+    #undef HAS_ARG
+}
+
+
+int pico_log_render(pico_log_ring *pRing, pico_flush_fn flush, void *pCtx) {
+    char pChunk[2 * PICOFORMAT_CHUNK_SIZE]; // two halves: one is filled while the other one is being transmitted
+    pico_out out = { pChunk, pChunk + PICOFORMAT_CHUNK_SIZE, pChunk, flush, pCtx, pChunk + PICOFORMAT_CHUNK_SIZE };
+    unsigned char pRecord[PICOLOG_MAX_RECORD];
+    int cRendered = 0;
+    uint32_t tail = pRing->tail;
+    for (uint32_t head = LOAD_ACQUIRE(&pRing->head); tail != head; cRendered++) {
+        ring_read(pRing, tail, pRecord, 2);
+        uint32_t cbRecord = get_u16(pRecord);
+        ring_read(pRing, tail + 2, pRecord + 2, cbRecord - 2);
+        tail += cbRecord;
+        STORE_RELEASE(&pRing->tail, tail); // released before rendering: the producers need not wait for it
+        replay(&out, pRecord, (const char *)(uintptr_t)get_u64(pRecord + 4));
+    }
+    if (out.pDest != out.pChunk) {
+        flush(pCtx, out.pChunk, out.pDest - out.pChunk);
+    }
+    return cRendered;
+}
+
+
+int pico_log_format(char *pDest, size_t cbDest, const void *pRecord, const char *pFormat) {
+    pico_out out = { pDest, cbDest ? pDest + cbDest - 1 : pDest, pDest };
+    replay(&out, (const unsigned char *)pRecord, pFormat);
+    if (cbDest) {
+        *out.pDest = '\0';
+    }
+    return (int)(out.cbCounted + (out.pDest - out.pChunk));
+}
@@ -0,0 +1,75 @@
+#ifndef __picolog_h_INCLUDED__
+#define __picolog_h_INCLUDED__
+
+// deferred logging: `pico_log_capture()` only copies the format pointer and the raw arguments into a binary ring,
+// and `pico_log_render()` renders them later (e.g. on a low-priority thread) through the same kernels as `pico_snprintf()`,
+// so the log lines that are never read cost a copy of their arguments rather than their rendering
+
+#include "picoprintf.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// the wire format of a record, little-endian regardless of the target, for the rings to be decoded offline
+//   offset 0: uint16  the size of the record in bytes, this header included
+//   offset 2: uint8   the version of the wire format: `PICOLOG_VERSION`
+//   offset 3: uint8   the size of a pointer on the target, i.e. of the "%p" arguments: 4 or 8
+//   offset 4: uint64  the address of the format string, to be mapped back to the string (e.g. from the ELF file) offline
+//   offset 12: the arguments, in the order of the format, without any padding
+//     '*' width or precision:          int32
+//     "%c", "%lc":                     32 bits
+//     "%d", "%u", "%x", etc.:          32 bits, or 64 bits with 'l' (and "%p" on the 64-bit targets)
+//     "%f", "%e", "%g", etc.:          the 64 bits of the IEEE-754 double
+//     "%s":                            uint16 length, then the chars without the null-terminator (cut at the precision)
+//     "%H":                            uint16 length, then the bytes
+#define PICOLOG_VERSION 1
+#define PICOLOG_HEADER_SIZE 12
+
+// a record that does not fit is cut: its strings and hex dumps are shortened first, and if that is not enough it is dropped
+// `pico_log_capture()` and `pico_log_render()` keep a record on the stack, so this is also their stack footprint
+#ifndef PICOLOG_MAX_RECORD
+    #define PICOLOG_MAX_RECORD 256
+#endif // PICOLOG_MAX_RECORD
+
+// by default, a ring has a single producer and a single consumer, and neither waits for the other
+// `PICO_LOG_MULTI_PRODUCER` lets several threads capture concurrently: each producer reserves its span with a
+// compare-and-swap, then publishes it in the order of the reservations, so a producer preempted between the two
+// stalls the later ones until it is resumed; so do not capture from an interrupt that can preempt a producer of the same ring
+#define PICO_LOG_MULTI_PRODUCER 1
+
+typedef struct {
+    unsigned char *pBuf;
+    uint32_t cbMask;                    // the size of `pBuf` minus one: the size is a power of two
+    unsigned flags;
+    uint32_t head;                      // free-running: the published records end here
+    uint32_t reserved;                  // free-running, multi-producer only: the records being written end here
+    uint32_t tail;                      // free-running: the records not rendered yet start here
+    uint32_t cDropped;                  // the records dropped for lack of space in the ring
+} pico_log_ring;
+
+// `cbBuf` must be a power of two, at least `PICOLOG_MAX_RECORD`; returns -1 if it is not
+int pico_log_init(pico_log_ring *pRing, void *pBuf, size_t cbBuf, unsigned flags);
+
+// producer side: walks `pFormat` once, only to copy its arguments; `pFormat` must outlive the record (e.g. a literal)
+// returns the size of the record, or -1 if it was dropped for lack of space in the ring, or has a custom conversion (see
+// `pico_register_conversion()`), whose arguments cannot be copied
+int pico_log_capture(pico_log_ring *pRing, const char *pFormat, ...);
+int pico_log_vcapture(pico_log_ring *pRing, const char *pFormat, va_list vl);
+
+// consumer side: renders the records captured so far, one after another, and hands the output over to `flush` in chunks
+// (see `pico_fctprintf()`); the record is released before it is rendered, so the producers can reuse its space meanwhile
+// returns the number of records rendered
+int pico_log_render(pico_log_ring *pRing, pico_flush_fn flush, void *pCtx);
+
+// renders a single record, e.g. read from a dump of the ring, with `pFormat` mapped from the address in its header
+// same return value as `pico_snprintf()`
+int pico_log_format(char *pDest, size_t cbDest, const void *pRecord, const char *pFormat);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __picolog_h_INCLUDED__
@@ -1,335 +1,2176 @@
 #include "picoprintf.h"
 #include "picobool.h"
 
-#include <math.h>    // fabs()
-#include <stdlib.h>  // llabs()
+#include <stdint.h>  // uint32_t, uint64_t for the exact float conversion and the hex digits
 
+#ifdef PICOFORMAT_FAST_COPY
+#include <string.h>  // memcpy(), memset(), memchr(), strlen(): the libc's bulk copies beat any loop of ours
 
-static void flip(char *pLeft, char *pRight) {
-    pRight--;
-    while (pLeft < pRight) {
-        char tmp = *pLeft;
-        *pLeft = *pRight;
-        *pRight = tmp;
-        pLeft++;
-        pRight--;
+// shorter spans are copied char by char: below this size, the call costs more than it saves
+#define FAST_COPY_MIN 16
+#endif // PICOFORMAT_FAST_COPY
+
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+#include <time.h>   // struct timespec, of the "%T" arguments: no time function of the libc is called
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+#if defined(__SSE2__)
+#include <emmintrin.h>  // 16 bytes to hex at a time
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>   // 16 bytes to hex at a time
+#endif // SIMD
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+
+// the per-thread state of `PICOFORMAT_STATS` and `PICOFORMAT_HANDLE_TIMESTAMP`, where the compiler has thread-local storage
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define THREAD_LOCAL __thread
+#endif // __STDC_VERSION__
+
+
+#ifdef PICOFORMAT_FAST_DECIMAL
+// "00".."99": lets the decimal conversion emit two digits per division
+static const char g_pDecimalPairs[200] =   // exactly 200 chars: no room for, and no need of, the null-terminator
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// writes the decimal digits of `val` right-to-left, ending just before `pRight`; returns the first digit
+// only 32-bit divisions are used, so 32-bit cores never call the 64-bit division helpers
+static char *u32toa_rtl(unsigned val, char *pRight) {
+    while (val >= 100) {
+        unsigned pair = (val % 100) * 2;
+        val /= 100;
+        *--pRight = g_pDecimalPairs[pair + 1];
+        *--pRight = g_pDecimalPairs[pair];
+    }
+    if (val >= 10) {
+        *--pRight = g_pDecimalPairs[val * 2 + 1];
+        *--pRight = g_pDecimalPairs[val * 2];
+    } else {
+        *--pRight = (char)('0' + val);
+    }
+    return pRight;
+}
+
+// same as `u32toa_rtl()`, but peels 8 digits per 64-bit division until the rest fits 32 bits
+static char *u64toa_rtl(unsigned long long val, char *pRight) {
+    while (val > 0xffffffffu) {
+        unsigned long long quotient = val / 100000000u;
+        unsigned low = (unsigned)(val - quotient * 100000000u);
+        val = quotient;
+        for (int ii = 0; ii < 4; ii++) {
+            unsigned pair = (low % 100) * 2;
+            low /= 100;
+            *--pRight = g_pDecimalPairs[pair + 1];
+            *--pRight = g_pDecimalPairs[pair];
+        }
+    }
+    return u32toa_rtl((unsigned)val, pRight);
+}
+
+static const unsigned long long g_pPowersOf10[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+    10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+    10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+};
+
+// number of decimal digits in `val`, without rendering them: log10 estimated from log2, then corrected with the table
+static int count_digits(unsigned long long val) {
+    val |= 1;                       // same number of digits, and no special case for zero
+#if defined(__GNUC__)
+    int bits = 64 - __builtin_clzll(val);
+#else  // __GNUC__
+    int bits = 0;
+    for (unsigned long long rest = val; rest; rest >>= 1, bits++);
+#endif // __GNUC__
+    int digits = (bits * 1233) >> 12;               // 1233 / 4096 ~= log10(2)
+    return digits + (val >= g_pPowersOf10[digits]);
+}
+#endif // PICOFORMAT_FAST_DECIMAL
+
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+static const char g_pLowercaseNumberDigits[] = "0123456789abcdef";
+static const char g_pUppercaseNumberDigits[] = "0123456789ABCDEF";
+#define g_pOctalDigits g_pLowercaseNumberDigits
+#define g_pBinaryDigits g_pLowercaseNumberDigits
+#endif // defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_HEXDUMP) || defined(PICOFORMAT_HANDLE_ARRAYS)
+// stores the 8 bytes of `val`, lowest first: a single unaligned store where the byte order allows
+static void store_le64(char *pDest, uint64_t val) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    __builtin_memcpy(pDest, &val, 8);
+#else  // little-endian __GNUC__
+    for (int ii = 0; ii < 8; ii++) {
+        pDest[ii] = (char)(val >> 8 * ii);
+    }
+#endif // little-endian __GNUC__
+}
+#endif // defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_HEXDUMP) || defined(PICOFORMAT_HANDLE_ARRAYS)
+
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+// SWAR: writes the 8 hex digits of `val`, most significant first, converting all of them at once
+// each nibble is spread into a byte of its own, and the bytes above 9 get the extra offset of the letters
+static void hex_u32(char *pDest, uint32_t val, bool upper) {
+    uint64_t nibbles = val;
+    nibbles = (nibbles | nibbles << 16) & 0x0000ffff0000ffffull;
+    nibbles = (nibbles | nibbles << 8) & 0x00ff00ff00ff00ffull;
+    nibbles = (nibbles | nibbles << 4) & 0x0f0f0f0f0f0f0f0full;
+    uint64_t letters = ((nibbles + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;  // 1 in the bytes above 9
+    nibbles += 0x3030303030303030ull + letters * (upper ? 'A' - '9' - 1 : 'a' - '9' - 1);
+#if defined(__GNUC__)
+    store_le64(pDest, __builtin_bswap64(nibbles));  // the most significant nibble is in the highest byte
+#else  // __GNUC__
+    for (int ii = 0; ii < 8; ii++) {
+        pDest[ii] = (char)(nibbles >> (56 - 8 * ii));
+    }
+#endif // __GNUC__
+}
+#endif // defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+
+#ifdef PICOFORMAT_HANDLE_ARRAYS
+// SWAR: the 8 decimal digits of `val` < 10^8 (leading zeros included) in the bytes of a word, first digit lowest, all at once
+// the lanes are split in halves by multiplying with the reciprocals: 4-digit lanes into 2-digit ones, then into single digits
+static uint64_t decimal_8digits(uint32_t val) {
+    uint64_t quads = val / 10000 | (uint64_t)(val % 10000) << 32;            // 2 lanes of 32 bits: 0..9999
+    uint64_t pairs = ((quads * 10486) >> 20) & 0x0000007f0000007full;         // x * 10486 >> 20 == x / 100 for x < 43699
+    pairs |= (quads - 100 * pairs) << 16;                                     // 4 lanes of 16 bits: 0..99
+    uint64_t digits = ((pairs * 103) >> 10) & 0x000f000f000f000full;          // x * 103 >> 10 == x / 10 for x < 179
+    return digits | (pairs - 10 * digits) << 8;                               // 8 lanes of 8 bits: 0..9
+}
+
+// writes the 8 digits as ASCII, first digit first
+static void store_8digits(char *pDest, uint64_t digits) {
+    store_le64(pDest, digits + 0x3030303030303030ull);
+}
+
+// writes the decimal digits of `val` without any branch per digit; returns their number
+// `pDest` must have the room for 16 chars: the digits are stored 8 at a time, past their end, too
+static int array_u32_digits(char *pDest, uint32_t val) {
+    if (val >= 100000000) {                         // 9 or 10 digits: the top 1 or 2, then 8 more
+        uint32_t top = val / 100000000;
+        int len = top >= 10;
+        pDest[0] = (char)('0' + top / 10);
+        pDest[len] = (char)('0' + top % 10);
+        store_8digits(pDest + len + 1, decimal_8digits(val - top * 100000000));
+        return len + 9;
+    }
+    uint64_t digits = decimal_8digits(val);         // the leading zeros are shifted out, but for the last digit
+#if defined(__GNUC__)
+    int zeros = digits ? __builtin_ctzll(digits) / 8 : 7;
+#else  // __GNUC__
+    int zeros = 0;
+    for (; zeros < 7 && 0 == (digits >> 8 * zeros & 0xff); zeros++);
+#endif // __GNUC__
+    store_8digits(pDest, digits >> 8 * zeros);
+    return 8 - zeros;
+}
+
+// same as `array_u32_digits()` with 8 digits per 64-bit division, while they do not fit 32 bits; `pDest` needs 28 chars
+static int array_u64_digits(char *pDest, uint64_t val) {
+    if (val <= 0xffffffffu) {
+        return array_u32_digits(pDest, (uint32_t)val);
+    }
+    uint64_t high = val / 100000000;
+    int len = array_u64_digits(pDest, high);        // at most twice: 2^64 has 20 digits
+    store_8digits(pDest + len, decimal_8digits((uint32_t)(val - high * 100000000)));
+    return len + 8;
+}
+#endif // PICOFORMAT_HANDLE_ARRAYS
+
+// using #define over `inline` for enabling porting to old C
+#if !defined(MIN)
+#define MIN(left, right) (((left) < (right)) ? (left) : (right))
+#endif
+#if !defined(MAX)
+#define MAX(left, right) (((left) > (right)) ? (left) : (right))
+#endif
+
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+// the conversions registered with `pico_register_conversion()`, by their char: one load away from both the parser and the renderer
+static pico_conversion_fn g_pConversions[PICO_CONVERSIONS];
+
+// the conversions and the length modifiers of C99, and the conversions of picoprintf's own, whether this build handles them or not:
+// a format keeps its meaning when a feature gets enabled
+static const char g_pReservedConversions[] = "aAbcdeEfFgGhHijLlnopQrstTuxXz";
+
+int pico_register_conversion(char ch, pico_conversion_fn handler) {
+    if (!((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z'))) {
+        return -1;
+    }
+    for (const char *pReserved = g_pReservedConversions; *pReserved; pReserved++) {
+        if (ch == *pReserved) {
+            return -1;
+        }
+    }
+    g_pConversions[ch - 'A'] = handler;
+    return 0;
+}
+#endif // PICOFORMAT_HANDLE_CUSTOM
+
+
+// parses the conversion specification following a '%'; returns the pointer past the conversion character
+static const char *parse_spec(const char *pFormat, pico_format_spec *pSpec) {
+    pico_format_spec empty = {0};
+    *pSpec = empty;
+    pSpec->decimal_chars = -1;      // if not specified, %f are rendered with 6, while %g are rendered with 0
+    for (; *pFormat && '\0' == pSpec->format; pFormat++) {
+        switch (*pFormat) {
+    #ifdef PICOFORMAT_HANDLE_FORCEDSIGN
+        case '+':
+            pSpec->flags.force_sign = 1;
+            break;
+    #endif // PICOFORMAT_HANDLE_FORCEDSIGN
+    #ifdef PICOFORMAT_HANDLE_FILL
+        case '-':    // left-align flag
+            pSpec->flags.left_align = 1;
+            break;
+    #endif // PICOFORMAT_HANDLE_FILL
+        case '0':
+            if (!pSpec->flags.seen_numbers) {
+                pSpec->flags.fill_zeros = 1;
+                break;
+            }
+            // fall through
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            *(pSpec->flags.seen_period ? &pSpec->decimal_chars : &pSpec->whole_chars ) *= 10;
+            *(pSpec->flags.seen_period ? &pSpec->decimal_chars : &pSpec->whole_chars) += *pFormat - '0';
+            pSpec->flags.seen_numbers = 1;
+            break;
+        case '.':
+            pSpec->flags.seen_numbers = pSpec->flags.seen_period = 1;
+            pSpec->decimal_chars = 0;
+            break;
+        case '*':                        // dynamic width/precision: the value is read from arg list at render time
+            if (pSpec->flags.seen_period) {
+                pSpec->flags.decimal_from_arg = 1;
+            } else {
+                pSpec->flags.whole_from_arg = 1;
+            }
+            pSpec->flags.seen_numbers = 1;
+            break;
+        case 'l':    // long modifier
+            pSpec->flags.treat_as_long = 1;
+            break;
+        case 'u':    // unsigned decimal integer
+            pSpec->flags.treat_as_unsigned = 1;
+            pSpec->format = 'd';
+            break;
+    #ifdef PICOFORMAT_HANDLE_BIN
+        case 'b':
+            pSpec->bits_per_digit = 1;
+            pSpec->flags.treat_as_unsigned = 1;
+            pSpec->format = 'b';
+            break;
+    #endif // PICOFORMAT_HANDLE_BIN
+    #ifdef PICOFORMAT_HANDLE_OCT
+        case 'o':    // octal integer
+            pSpec->bits_per_digit = 3;
+            pSpec->flags.treat_as_unsigned = 1;
+            pSpec->format = 'b';
+            break;
+    #endif // PICOFORMAT_HANDLE_OCT
+    #ifdef PICOFORMAT_HANDLE_HEX
+        case 'p':    // pointer: as wide as it takes
+            pSpec->flags.treat_as_long = sizeof(void *) > sizeof(unsigned);
+            // fall through
+        case 'x':    // hexadecimal integer
+            pSpec->bits_per_digit = 4;
+            pSpec->flags.treat_as_unsigned = 1;
+            pSpec->flags.render_in_lowercase = 1;
+            pSpec->format = 'b';
+            break;
+        case 'X':    // hexadecimal integer, uppercase
+            pSpec->bits_per_digit = 4;
+            pSpec->flags.treat_as_unsigned = 1;
+            pSpec->format = 'b';
+            break;
+    #endif // PICOFORMAT_HANDLE_HEX
+    #ifdef PICOFORMAT_HANDLE_HEXDUMP
+        case 'H':    // hex dump of the bytes at a pointer: the width is the number of bytes, e.g. "%*H" or "%16H"
+            pSpec->format = 'H';
+            break;
+    #endif // PICOFORMAT_HANDLE_HEXDUMP
+    #ifdef PICOFORMAT_HANDLE_TIMESTAMP
+        case 'T':    // UTC timestamp: the precision is the digits of the second's fraction, e.g. "%.3T" of a `struct timespec *`
+            pSpec->format = 'T';
+            break;
+    #endif // PICOFORMAT_HANDLE_TIMESTAMP
+    #ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+        case 'Q': {  // fixed point: the number of fractional bits follows, e.g. "%.3Q16" for a Q16.16 `int`
+            int bits = 0;
+            for (; pFormat[1] >= '0' && pFormat[1] <= '9'; pFormat++) {
+                bits = MIN(bits * 10 + pFormat[1] - '0', 100);
+            }
+            if (bits > 60) {
+                FORMAT_ERROR_DELEGATE("detected too many fractional bits (up to 60): %d", bits);
+                bits = 60;
+            }
+            pSpec->fraction_bits = (signed char)bits;
+            pSpec->format = 'Q';
+            break;
+        }
+    #endif // PICOFORMAT_HANDLE_FIXEDPOINT
+    #ifdef PICOFORMAT_HANDLE_FLOATS
+    #ifdef PICOFORMAT_HANDLE_EXPONENTS
+        case 'e':   // floating point, exponent format
+        case 'g':   // floating point, the shorter of the fixed and the exponent formats
+        case 'r':   // floating point, the shortest digits that read back to the same value (non-standard)
+    #endif // PICOFORMAT_HANDLE_EXPONENTS
+        case 'f':
+            pSpec->flags.render_in_lowercase = 1;
+            pSpec->format = *pFormat;
+            break;
+    #ifdef PICOFORMAT_HANDLE_EXPONENTS
+        case 'E':
+        case 'G':
+    #endif // PICOFORMAT_HANDLE_EXPONENTS
+        case 'F':
+    #endif // PICOFORMAT_HANDLE_FLOATS
+        case 'c':  // single char: always supported
+        case 'd':  // integer: always supported
+        case 'i':  // integer: always supported
+        case 's':  // string of native `char`s: always supported
+            pSpec->format = *pFormat;
+            break;
+        default:
+    #ifdef PICOFORMAT_HANDLE_CUSTOM
+            // only the chars that no case above takes get here: the built-in conversions never look the table up
+            if (*pFormat >= 'A' && *pFormat <= 'z' && g_pConversions[*pFormat - 'A']) {
+                pSpec->format = *pFormat;
+                break;
+            }
+    #endif // PICOFORMAT_HANDLE_CUSTOM
+            FORMAT_ERROR_DELEGATE("detected unhandled format specifier: %c", *pFormat);
+            break;
+        }
+    }
+    return pFormat;
+}
+
+
+#define OUT_TOTAL(pOut) ((pOut)->cbCounted + ((pOut)->pDest - (pOut)->pChunk))
+
+// only counting from now on: the measure mode, or the buffer mode out of space
+#define OUT_FULL(pOut) (NULL == (pOut)->flush && (pOut)->pDest == (pOut)->pEnd)
+
+
+// sink mode: hands the filled half-chunk over to the sink, and continues in the other half, so that the sink
+// can transmit the flushed span asynchronously (e.g. by DMA) until it is called the next time
+static void out_flush(pico_out *pOut) {
+    size_t cbFilled = pOut->pDest - pOut->pChunk;
+    if (cbFilled) {
+        pOut->flush(pOut->pCtx, pOut->pChunk, cbFilled);
+        pOut->cbCounted += cbFilled;
+        char *pNext = pOut->pSpare;
+        pOut->pSpare = pOut->pChunk;
+        pOut->pEnd = pNext + (pOut->pEnd - pOut->pChunk);
+        pOut->pChunk = pOut->pDest = pNext;
+    }
+}
+
+
+static void out_putc(pico_out *pOut, char ch) {
+    if (pOut->pDest == pOut->pEnd) {
+        if (!pOut->flush) {
+            pOut->cbCounted++;      // buffer mode: truncated, but still counted
+            return;
+        }
+        out_flush(pOut);
+    }
+    *pOut->pDest++ = ch;
+}
+
+
+static void out_write(pico_out *pOut, const char *pSrc, size_t cbSrc) {
+    while (cbSrc) {
+        if (pOut->pDest == pOut->pEnd) {
+            if (!pOut->flush) {
+                pOut->cbCounted += cbSrc;   // buffer mode: truncated, but still counted
+                return;
+            }
+            out_flush(pOut);
+        }
+        char *pDest = pOut->pDest;  // a local copy: the stores below could otherwise alias `pOut->pDest`
+        size_t cbSpan = MIN(cbSrc, (size_t)(pOut->pEnd - pDest));  // one bound check per span, not per char
+#ifdef PICOFORMAT_FAST_COPY
+        if (cbSpan >= FAST_COPY_MIN) {
+            memcpy(pDest, pSrc, cbSpan);
+        } else
+#endif // PICOFORMAT_FAST_COPY
+        for (size_t ii = 0; ii < cbSpan; ii++) {
+            pDest[ii] = pSrc[ii];
+        }
+        pOut->pDest = pDest + cbSpan;
+        pSrc += cbSpan;
+        cbSrc -= cbSpan;
+    }
+}
+
+
+#ifdef PICOFORMAT_HANDLE_FILL
+static void out_fill(pico_out *pOut, char ch, int count) {
+    if (NULL == pOut->pDest && count > 0) {
+        pOut->cbCounted += count;   // measure mode
+        return;
+    }
+#ifdef PICOFORMAT_FAST_COPY
+    while (count > 0) {             // the same spans as `out_write()`, set at once
+        if (pOut->pDest == pOut->pEnd) {
+            if (!pOut->flush) {
+                pOut->cbCounted += count;
+                return;
+            }
+            out_flush(pOut);
+        }
+        char *pDest = pOut->pDest;
+        size_t cbSpan = MIN((size_t)count, (size_t)(pOut->pEnd - pDest));
+        if (cbSpan >= FAST_COPY_MIN) {
+            memset(pDest, ch, cbSpan);
+        } else {
+            for (size_t ii = 0; ii < cbSpan; ii++) {
+                pDest[ii] = ch;
+            }
+        }
+        pOut->pDest = pDest + cbSpan;
+        count -= (int)cbSpan;
+    }
+#else  // PICOFORMAT_FAST_COPY
+    for (; count > 0; count--) {
+        out_putc(pOut, ch);
+    }
+#endif // PICOFORMAT_FAST_COPY
+}
+#endif // PICOFORMAT_HANDLE_FILL
+
+
+#ifdef PICOFORMAT_FAST_COPY
+#define ONES_64 0x0101010101010101ull
+#define HIGHS_64 0x8080808080808080ull
+
+// non-zero if a byte of `word` is zero (the lowest such byte is always flagged, the ones above it may be false positives)
+#define HAS_ZERO_BYTE(word) (((word) - ONES_64) & ~(word) & HIGHS_64)
+
+// the next '%' (or the null-terminator): one by one up to an 8-byte boundary, 8 chars per step from there, then the
+// last few one by one
+// an aligned 8-byte load never straddles the end of a page or of a memory protection region, so the bytes it reads
+// past the null-terminator are in the same word as the null-terminator, and never fault; AddressSanitizer would still
+// report them, so they are not instrumented
+#if defined(__GNUC__)
+__attribute__((no_sanitize_address))
+#endif // __GNUC__
+static const char *find_specifier(const char *pFormat) {
+    for (; (uintptr_t)pFormat & 7; pFormat++) {
+        if (!*pFormat || '%' == *pFormat) {
+            return pFormat;
+        }
+    }
+    for (;; pFormat += 8) {
+        uint64_t word;
+#if defined(__GNUC__)
+        __builtin_memcpy(&word, __builtin_assume_aligned(pFormat, 8), 8);   // a single load: the order of the bytes does not matter to the test
+#else  // __GNUC__
+        memcpy(&word, pFormat, 8);
+#endif // __GNUC__
+        if (HAS_ZERO_BYTE(word) | HAS_ZERO_BYTE(word ^ (ONES_64 * '%'))) {
+            break;
+        }
+    }
+    for (; *pFormat && '%' != *pFormat; pFormat++);
+    return pFormat;
+}
+
+
+// copies the literal text up to the next '%'; returns the pointer to the '%' (or to the end of the format)
+// most literals between specifiers are short, and are copied in the same pass that finds their end; only a longer
+// rest is searched 8 chars at a time, and then copied with a single `memcpy()`
+static const char *out_literal(pico_out *pOut, const char *pFormat) {
+    char *pDest = pOut->pDest;
+    if (pOut->pEnd - pDest >= FAST_COPY_MIN) {      // room for all the short ones: no bound check per char
+        for (const char *pShort = pFormat + FAST_COPY_MIN; pFormat < pShort && *pFormat && '%' != *pFormat; ) {
+            *pDest++ = *pFormat++;
+        }
+        pOut->pDest = pDest;
+        if (!*pFormat || '%' == *pFormat) {
+            return pFormat;
+        }
+    }
+    const char *pStop = find_specifier(pFormat);
+    if (OUT_FULL(pOut)) {
+        pOut->cbCounted += pStop - pFormat;
+    } else {
+        out_write(pOut, pFormat, pStop - pFormat);
+    }
+    return pStop;
+}
+#else  // PICOFORMAT_FAST_COPY
+// copies the literal text up to the next '%' in a single pass; returns the pointer to the '%' (or to the end of the format)
+static const char *out_literal(pico_out *pOut, const char *pFormat) {
+    for (;;) {
+        char *pDest = pOut->pDest;
+        for (char *pEnd = pOut->pEnd; pDest < pEnd && *pFormat && '%' != *pFormat; ) {
+            *pDest++ = *pFormat++;
+        }
+        pOut->pDest = pDest;
+        if (!*pFormat || '%' == *pFormat) {
+            return pFormat;
+        }
+        if (!pOut->flush) {         // the buffer mode is out of space: only count the rest
+            const char *pRest = pFormat;
+            for (; *pFormat && '%' != *pFormat; pFormat++);
+            pOut->cbCounted += pFormat - pRest;
+            return pFormat;
+        }
+        out_flush(pOut);
+    }
+}
+#endif // PICOFORMAT_FAST_COPY
+
+
+// emits a number rendered into [pDigits, pDigitsEnd) with its sign (if any), padded to `whole_chars`
+static void emit_number(pico_out *pOut, const pico_format_spec *pSpec, int whole_chars, char chSign, const char *pDigits, const char *pDigitsEnd) {
+#ifdef PICOFORMAT_HANDLE_FILL
+    int padding = whole_chars - (int)(pDigitsEnd - pDigits) - ('\0' != chSign);
+    if (!pSpec->flags.left_align && !pSpec->flags.fill_zeros) {
+        out_fill(pOut, ' ', padding);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+    if ('\0' != chSign) {           // the sign goes before the zeros, but after the spaces
+        out_putc(pOut, chSign);
+    }
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (!pSpec->flags.left_align && pSpec->flags.fill_zeros) {
+        out_fill(pOut, '0', padding);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+    out_write(pOut, pDigits, pDigitsEnd - pDigits);
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (pSpec->flags.left_align) {  // left-align: pad on the right (always spaces; '-' flag overrides '0')
+        out_fill(pOut, ' ', padding);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+}
+
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+// writes the 32 hex digits of 16 bytes
+static void hex_16(char *pDest, const unsigned char *pSrc, bool upper) {
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128((const __m128i *)pSrc);
+    __m128i low = _mm_set1_epi8(0x0f), nine = _mm_set1_epi8(9), zero = _mm_set1_epi8('0');
+    __m128i letters = _mm_set1_epi8(upper ? 'A' - '9' - 1 : 'a' - '9' - 1);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), low);
+    bytes = _mm_and_si128(bytes, low);
+    __m128i pHalves[2] = { _mm_unpacklo_epi8(high, bytes), _mm_unpackhi_epi8(high, bytes) };   // the nibbles in output order
+    for (int ii = 0; ii < 2; ii++) {
+        __m128i digits = _mm_add_epi8(pHalves[ii], zero);
+        digits = _mm_add_epi8(digits, _mm_and_si128(_mm_cmpgt_epi8(pHalves[ii], nine), letters));
+        _mm_storeu_si128((__m128i *)(pDest + 16 * ii), digits);
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t bytes = vld1q_u8(pSrc);
+    uint8x16x2_t nibbles = { { vshrq_n_u8(bytes, 4), vandq_u8(bytes, vdupq_n_u8(0x0f)) } };
+    uint8x16_t letters = vdupq_n_u8(upper ? 'A' - '9' - 1 : 'a' - '9' - 1);
+    for (int ii = 0; ii < 2; ii++) {
+        uint8x16_t digits = vaddq_u8(nibbles.val[ii], vdupq_n_u8('0'));
+        nibbles.val[ii] = vaddq_u8(digits, vandq_u8(vcgtq_u8(nibbles.val[ii], vdupq_n_u8(9)), letters));
+    }
+    vst2q_u8((uint8_t *)pDest, nibbles);             // interleaves the high and the low nibbles on the way out
+#else  // SIMD
+    for (int ii = 0; ii < 16; ii += 4) {
+        hex_u32(pDest + 2 * ii, (uint32_t)pSrc[ii] << 24 | (uint32_t)pSrc[ii + 1] << 16 | (uint32_t)pSrc[ii + 2] << 8 | pSrc[ii + 3], upper);
+    }
+#endif // SIMD
+}
+
+
+// writes the 2 * `cbSrc` hex digits of `pSrc`: 16 bytes at a time, then 4 at a time, then the rest one by one
+static void hex_bytes(char *pDest, const unsigned char *pSrc, size_t cbSrc, bool upper) {
+    for (; cbSrc >= 16; cbSrc -= 16, pSrc += 16, pDest += 32) {
+        hex_16(pDest, pSrc, upper);
+    }
+    for (; cbSrc >= 4; cbSrc -= 4, pSrc += 4, pDest += 8) {
+        hex_u32(pDest, (uint32_t)pSrc[0] << 24 | (uint32_t)pSrc[1] << 16 | (uint32_t)pSrc[2] << 8 | pSrc[3], upper);
+    }
+    const char *pDigits = upper ? g_pUppercaseNumberDigits : g_pLowercaseNumberDigits;
+    for (; cbSrc; cbSrc--, pSrc++) {
+        *pDest++ = pDigits[*pSrc >> 4];
+        *pDest++ = pDigits[*pSrc & 0xf];
+    }
+}
+
+
+static void render_hexdump(pico_out *pOut, const unsigned char *pSrc, size_t cbSrc, bool upper, bool spaced) {
+    size_t cbTotal = 2 * cbSrc + (spaced && cbSrc ? cbSrc - 1 : 0);
+    if (!spaced && NULL == pOut->flush && (size_t)(pOut->pEnd - pOut->pDest) >= cbTotal) {
+        hex_bytes(pOut->pDest, pSrc, cbSrc, upper);   // the whole dump fits the buffer: straight into it
+        pOut->pDest += cbTotal;
+        return;
+    }
+    char pBlock[32];                                // otherwise, through `pico_out` in blocks of 16 bytes
+    for (size_t done = 0; done < cbSrc; ) {
+        if (OUT_FULL(pOut)) {                       // only counting: no need to render the digits
+            pOut->cbCounted += 2 * (cbSrc - done) + (spaced ? cbSrc - done - !done : 0);
+            return;
+        }
+        size_t cbBlock = MIN(cbSrc - done, 16);
+        hex_bytes(pBlock, pSrc + done, cbBlock, upper);
+        if (spaced) {
+            for (size_t ii = 0; ii < cbBlock; ii++) {
+                if (done + ii) {
+                    out_putc(pOut, ' ');
+                }
+                out_write(pOut, pBlock + 2 * ii, 2);
+            }
+        } else {
+            out_write(pOut, pBlock, 2 * cbBlock);
+        }
+        done += cbBlock;
+    }
+}
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+
+#ifdef PICOFORMAT_HANDLE_FLOATS
+//
+// exact, integer-only floating point conversion: no libm, no FPU, no rounding errors
+//  the value m * 2^e2 is kept as the ratio r / s of two big integers, scaled by 10^k into [0.1, 1), and the digits are
+//  peeled off one at a time (Steele & White's "Dragon4", with Burger & Dybvig's setup for the shortest representation);
+//  when s fits in 60 bits, which covers the values from ~0.004 to ~1e18, the same is done with plain 64-bit integers
+//
+#define BIG_LIMBS 38                    // 1216 bits: enough for the largest numerator, 2^55 * 10^325
+
+typedef struct {
+    int cLimbs;                         // number of limbs in use: the value is 0 if none
+    uint32_t pLimbs[BIG_LIMBS];         // least significant first
+} pico_big;
+
+
+static void big_set(pico_big *pBig, uint64_t val) {
+    pBig->pLimbs[0] = (uint32_t)val;
+    pBig->pLimbs[1] = (uint32_t)(val >> 32);
+    pBig->cLimbs = (val >> 32) ? 2 : val ? 1 : 0;
+}
+
+
+static void big_copy(pico_big *pDest, const pico_big *pSrc) {
+    pDest->cLimbs = pSrc->cLimbs;
+    for (int ii = 0; ii < pSrc->cLimbs; ii++) {
+        pDest->pLimbs[ii] = pSrc->pLimbs[ii];
+    }
+}
+
+
+static void big_mul_small(pico_big *pBig, uint32_t mul) {
+    uint64_t carry = 0;
+    for (int ii = 0; ii < pBig->cLimbs; ii++) {
+        carry += (uint64_t)pBig->pLimbs[ii] * mul;
+        pBig->pLimbs[ii] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    if (carry) {
+        pBig->pLimbs[pBig->cLimbs++] = (uint32_t)carry;
+    }
+}
+
+
+static void big_mul_pow10(pico_big *pBig, int exp10) {
+    for (; exp10 >= 9; exp10 -= 9) {
+        big_mul_small(pBig, 1000000000u);
+    }
+    uint32_t mul = 1;
+    for (; exp10 > 0; exp10--) {
+        mul *= 10;
+    }
+    big_mul_small(pBig, mul);
+}
+
+
+static void big_shl(pico_big *pBig, int bits) {
+    int limbs = bits / 32;
+    bits %= 32;
+    if (bits) {
+        uint32_t carry = 0;
+        for (int ii = 0; ii < pBig->cLimbs; ii++) {
+            uint32_t limb = pBig->pLimbs[ii];
+            pBig->pLimbs[ii] = (limb << bits) | carry;
+            carry = limb >> (32 - bits);
+        }
+        if (carry) {
+            pBig->pLimbs[pBig->cLimbs++] = carry;
+        }
+    }
+    if (limbs && pBig->cLimbs) {
+        for (int ii = pBig->cLimbs - 1; ii >= 0; ii--) {
+            pBig->pLimbs[ii + limbs] = pBig->pLimbs[ii];
+        }
+        for (int ii = 0; ii < limbs; ii++) {
+            pBig->pLimbs[ii] = 0;
+        }
+        pBig->cLimbs += limbs;
+    }
+}
+
+
+static int big_cmp(const pico_big *pLeft, const pico_big *pRight) {
+    if (pLeft->cLimbs != pRight->cLimbs) {
+        return pLeft->cLimbs < pRight->cLimbs ? -1 : 1;
+    }
+    for (int ii = pLeft->cLimbs - 1; ii >= 0; ii--) {
+        if (pLeft->pLimbs[ii] != pRight->pLimbs[ii]) {
+            return pLeft->pLimbs[ii] < pRight->pLimbs[ii] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+// pBig += pAdd
+static void big_add(pico_big *pBig, const pico_big *pAdd) {
+    uint64_t carry = 0;
+    int ii = 0;
+    for (; ii < pAdd->cLimbs || (carry && ii < pBig->cLimbs); ii++) {
+        carry += (uint64_t)(ii < pBig->cLimbs ? pBig->pLimbs[ii] : 0) + (ii < pAdd->cLimbs ? pAdd->pLimbs[ii] : 0);
+        pBig->pLimbs[ii] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    pBig->cLimbs = MAX(pBig->cLimbs, ii);
+    if (carry) {
+        pBig->pLimbs[pBig->cLimbs++] = (uint32_t)carry;
+    }
+}
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+
+
+// pBig -= pSub, which must not be greater than pBig
+static void big_sub(pico_big *pBig, const pico_big *pSub) {
+    int64_t borrow = 0;
+    for (int ii = 0; ii < pBig->cLimbs; ii++) {
+        borrow += (int64_t)pBig->pLimbs[ii] - (ii < pSub->cLimbs ? pSub->pLimbs[ii] : 0);
+        pBig->pLimbs[ii] = (uint32_t)borrow;
+        borrow = borrow < 0 ? -1 : 0;
+    }
+    for (; pBig->cLimbs && !pBig->pLimbs[pBig->cLimbs - 1]; pBig->cLimbs--);
+}
+
+
+// pBig -= pSub * mul, which must not be greater than pBig
+static void big_sub_mul(pico_big *pBig, const pico_big *pSub, uint32_t mul) {
+    uint64_t carry = 0;
+    int64_t borrow = 0;
+    for (int ii = 0; ii < pBig->cLimbs; ii++) {
+        carry += ii < pSub->cLimbs ? (uint64_t)pSub->pLimbs[ii] * mul : 0;
+        borrow += (int64_t)pBig->pLimbs[ii] - (uint32_t)carry;
+        carry >>= 32;
+        pBig->pLimbs[ii] = (uint32_t)borrow;
+        borrow = borrow < 0 ? -1 : 0;
+    }
+    for (; pBig->cLimbs && !pBig->pLimbs[pBig->cLimbs - 1]; pBig->cLimbs--);
+}
+
+
+// shifts the ratio's terms left until the top bit of `pS` is set, so that `big_next_digit()` can guess the digits
+static void big_normalize(pico_big *pS, pico_big *pR, pico_big *pOther) {
+    int bits = 0;
+    for (uint32_t top = pS->pLimbs[pS->cLimbs - 1]; top < (1u << 31); top <<= 1, bits++);
+    big_shl(pS, bits);
+    big_shl(pR, bits);
+    if (pOther) {
+        big_shl(pOther, bits);
+    }
+}
+
+
+// r = r * 10 mod s; returns r * 10 / s, which is a single digit as long as r < s
+// the digit is guessed from the top limbs (off by one at most, as `s` is normalized), and then fixed up
+static int big_next_digit(pico_big *pR, const pico_big *pS) {
+    big_mul_small(pR, 10);
+    int top = pS->cLimbs - 1;
+    if (pR->cLimbs <= top) {
+        return 0;
+    }
+    uint64_t rTop = ((uint64_t)(pR->cLimbs > top + 1 ? pR->pLimbs[top + 1] : 0) << 32) | pR->pLimbs[top];
+    int digit = (int)(rTop / ((uint64_t)pS->pLimbs[top] + 1));
+    if (digit) {
+        big_sub_mul(pR, pS, (uint32_t)digit);
+    }
+    for (; big_cmp(pR, pS) >= 0; digit++) {
+        big_sub(pR, pS);
+    }
+    return digit;
+}
+
+
+// floor(exp2 * log10(2)) for |exp2| < 1700, with 78913 / 2^18 ~= log10(2)
+static int floor_log10_pow2(int exp2) {
+    return exp2 >= 0 ? (exp2 * 78913) >> 18 : -((-exp2 * 78913 + (1 << 18) - 1) >> 18);
+}
+
+
+typedef struct {
+    int k;                              // decimal exponent: the value is 0.d0d1d2... * 10^k
+    int cDigits;                        // number of digits to render, the ones past it are zeros
+    int iLastNon9;                      // exact modes: the digits past it are all '9' before the rounding
+    int iLastNonZero;                   // the digits past it are all '0' after the rounding
+    bool round_up;                      // exact modes: the digits are rounded up at `cDigits`
+    bool carry;                         // exact modes: the rounding carried all the way to a new leading digit
+    bool small;                         // exact modes: `r64` / `s64` are in use instead of `r` / `s`
+    int iNext;                          // exact modes: index of the digit `r` / `r64` is going to produce next
+    int digit;                          // exact modes: the last digit produced
+    uint64_t r64, s64, r64Start;
+    pico_big r, s, rStart;
+    char pShortest[18];                 // shortest mode: the digits, the rest is never more than 17 digits
+} pico_float;
+
+
+static int float_next_digit(pico_float *pF) {
+    int digit;
+    if (pF->small) {
+        pF->r64 *= 10;
+        digit = (int)(pF->r64 / pF->s64);
+        pF->r64 %= pF->s64;
+    } else {
+        digit = big_next_digit(&pF->r, &pF->s);
+    }
+    pF->iNext++;
+    return digit;
+}
+
+
+// exact modes: sets r / s to the non-zero m * 2^e2 scaled into [0.1, 1), i.e. finds `k`
+static void float_init_exact(pico_float *pF, uint64_t m, int e2) {
+    pF->r64 = pF->s64 = 0;
+    big_set(&pF->r, m);
+    big_set(&pF->s, 1);
+    big_shl(e2 >= 0 ? &pF->r : &pF->s, e2 >= 0 ? e2 : -e2);
+    int bits = e2 - 1;
+    for (uint64_t rest = m; rest; rest >>= 1, bits++);
+    pF->k = floor_log10_pow2(bits) + 1;             // either right or a bit too small
+    big_mul_pow10(pF->k >= 0 ? &pF->s : &pF->r, pF->k >= 0 ? pF->k : -pF->k);
+    for (; big_cmp(&pF->r, &pF->s) >= 0; pF->k++) {
+        big_mul_small(&pF->s, 10);
+    }
+    pF->small = pF->s.cLimbs < 2 || (2 == pF->s.cLimbs && pF->s.pLimbs[1] < (1u << 28));
+    if (pF->small) {
+        pF->r64 = pF->r.pLimbs[0] | (pF->r.cLimbs > 1 ? (uint64_t)pF->r.pLimbs[1] << 32 : 0);
+        pF->s64 = pF->s.pLimbs[0] | (pF->s.cLimbs > 1 ? (uint64_t)pF->s.pLimbs[1] << 32 : 0);
+        pF->r64 = pF->r.cLimbs ? pF->r64 : 0;
+    } else {
+        big_normalize(&pF->s, &pF->r, NULL);
+    }
+}
+
+
+// exact modes, the first pass: runs through `cDigits` digits to find out how they round and where the nines and the zeros are
+static void float_round(pico_float *pF, int cDigits) {
+    pF->cDigits = cDigits;
+    pF->iLastNon9 = pF->iLastNonZero = -1;
+    pF->iNext = 0;
+    pF->digit = 0;
+    pF->r64Start = pF->r64;
+    big_copy(&pF->rStart, &pF->r);
+    for (int ii = 0; ii < cDigits; ii++) {
+        pF->digit = float_next_digit(pF);
+        pF->iLastNon9 = 9 != pF->digit ? ii : pF->iLastNon9;
+        pF->iLastNonZero = 0 != pF->digit ? ii : pF->iLastNonZero;
+    }
+    if (cDigits >= 0) {                             // round half to even, like glibc
+        int cmp;
+        if (pF->small) {
+            cmp = pF->r64 * 2 < pF->s64 ? -1 : pF->r64 * 2 > pF->s64 ? 1 : 0;
+        } else {
+            big_mul_small(&pF->r, 2);
+            cmp = big_cmp(&pF->r, &pF->s);
+        }
+        pF->round_up = cmp > 0 || (0 == cmp && (pF->digit & 1));
+    }
+    if (pF->round_up) {
+        pF->carry = pF->iLastNon9 < 0;              // e.g. 9.996 -> 10.00
+        pF->k += pF->carry;
+        pF->iLastNonZero = pF->carry ? 0 : pF->iLastNon9;
+    }
+    pF->r64 = pF->r64Start;                         // rewinding for the second pass
+    big_copy(&pF->r, &pF->rStart);
+    pF->iNext = 0;
+}
+
+
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+// shortest mode: the fewest digits that read back to the same non-zero m * 2^e2 (Burger & Dybvig's free-format algorithm)
+static void float_shortest(pico_float *pF, uint64_t m, int e2) {
+    pico_big *pR = &pF->r, *pS = &pF->s, *pMinus = &pF->rStart;    // the lower margin: the upper one is the same, or twice as big
+    pico_big sum;
+    bool unequal = (1ull << 52) == m && e2 > -1074;                 // at powers of two, the gap below is half the gap above
+    bool inclusive = 0 == (m & 1);                                  // round-half-to-even reading accepts the exact midpoints
+    big_set(pR, m);
+    big_shl(pR, 1 + unequal);
+    if (e2 >= 0) {
+        big_shl(pR, e2);
+        big_set(pS, 2 << unequal);
+        big_set(pMinus, 1);
+        big_shl(pMinus, e2);
+    } else {
+        big_set(pS, 2 << unequal);
+        big_shl(pS, -e2);
+        big_set(pMinus, 1);
+    }
+    int bits = e2 - 1;
+    for (uint64_t rest = m; rest; rest >>= 1, bits++);
+    pF->k = floor_log10_pow2(bits) + 1;
+    if (pF->k >= 0) {
+        big_mul_pow10(pS, pF->k);
+    } else {
+        big_mul_pow10(pR, -pF->k);
+        big_mul_pow10(pMinus, -pF->k);
+    }
+    for (;;) {                                      // fixing `k` up, so that the upper bound is below 10^k
+        big_copy(&sum, pMinus);
+        big_shl(&sum, unequal);
+        big_add(&sum, pR);
+        int cmp = big_cmp(&sum, pS);
+        if (inclusive ? cmp < 0 : cmp <= 0) {
+            break;
+        }
+        big_mul_small(pS, 10);
+        pF->k++;
+    }
+    big_normalize(pS, pR, pMinus);
+    for (pF->cDigits = 0; ; ) {
+        int digit = big_next_digit(pR, pS);
+        big_mul_small(pMinus, 10);
+        int cmp = big_cmp(pR, pMinus);
+        bool low = inclusive ? cmp <= 0 : cmp < 0;  // the digits so far are within the lower margin
+        big_copy(&sum, pMinus);
+        big_shl(&sum, unequal);
+        big_add(&sum, pR);
+        cmp = big_cmp(&sum, pS);
+        bool high = inclusive ? cmp >= 0 : cmp > 0; // the next digit up is within the upper margin
+        if (low && high) {                          // both are: the closer one wins
+            big_mul_small(pR, 2);
+            cmp = big_cmp(pR, pS);
+            digit += cmp > 0 || (0 == cmp && (digit & 1));
+        } else if (high) {
+            digit++;
+        }
+        pF->pShortest[pF->cDigits++] = (char)('0' + digit);
+        if (low || high) {
+            break;
+        }
+    }
+    for (pF->iLastNonZero = pF->cDigits - 1; pF->iLastNonZero > 0 && '0' == pF->pShortest[pF->iLastNonZero]; pF->iLastNonZero--);
+}
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+
+
+// the second pass: returns the digit at `index`, which must not decrease from one call to the next
+static char float_digit(pico_float *pF, int index, bool shortest) {
+    if (index < 0 || index >= pF->cDigits + pF->carry) {
+        return '0';
+    }
+    if (shortest) {
+        return pF->pShortest[index];
+    }
+    if (pF->carry) {
+        return index ? '0' : '1';
+    }
+    if (index > pF->iLastNon9) {
+        return pF->round_up ? '0' : '9';
+    }
+    while (pF->iNext <= index) {
+        pF->digit = float_next_digit(pF);
+    }
+    return (char)('0' + pF->digit + (index == pF->iLastNon9 && pF->round_up));
+}
+
+
+static void emit_double(pico_out *pOut, const pico_format_spec *pSpec, double val) {
+    int decimal_chars = pSpec->decimal_chars;
+    union {
+        double val;
+        uint64_t bits;
+    } pun = { val };
+    uint64_t m = pun.bits & ((1ull << 52) - 1);
+    int exponent = (int)(pun.bits >> 52) & 0x7ff;
+    char chSign = (pun.bits >> 63) ? '-' : pSpec->flags.force_sign ? '+' : '\0';
+    char format = pSpec->format | 0x20;             // lowercase
+    const char *pExponent = pSpec->flags.render_in_lowercase ? "e" : "E";
+    int len = '\0' != chSign;
+    pico_float f;
+    f.cDigits = f.iLastNonZero = 0;
+    f.k = 1;                                        // zero is rendered as 0.0 * 10^1
+    f.round_up = f.carry = false;
+    f.iLastNon9 = -1;
+    bool shortest = false;
+    bool positional = 'f' == format;                // "123.456" rather than "1.23456e+02"
+    int fraction = decimal_chars < 0 ? 6 : decimal_chars;   // number of digits after the period
+
+    if (0x7ff == exponent) {                        // infinity or NaN
+        len += 3;
+        positional = false;
+        format = '\0';
+    } else {
+        if (exponent) {
+            m |= 1ull << 52;
+        } else {
+            exponent = 1;                           // subnormal
+        }
+        int e2 = exponent - 1075;
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+        shortest = 'r' == format;
+        if (shortest) {
+            if (m) {
+                float_shortest(&f, m, e2);
+            } else {
+                f.cDigits = 1;
+                f.pShortest[0] = '0';
+            }
+            positional = f.k - 1 >= -4 && f.k - 1 < 17;
+            fraction = positional ? MAX(0, f.iLastNonZero + 1 - f.k) : f.iLastNonZero;
+        } else
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+        {
+            int precision = 'g' == format ? (decimal_chars < 0 ? 6 : decimal_chars ? decimal_chars : 1) : fraction;
+            if (m) {
+                float_init_exact(&f, m, e2);
+                float_round(&f, 'f' == format ? f.k + precision : 'e' == format ? precision + 1 : precision);
+            }
+            if ('g' == format) {                    // positional if the exponent is in [-4, precision), and no trailing zeros
+                positional = f.k - 1 >= -4 && f.k - 1 < precision;
+                int significant = MAX(f.iLastNonZero, 0) + 1;
+                fraction = positional ? MAX(0, significant - f.k) : significant - 1;
+            }
+        }
+        len += (positional ? MAX(f.k, 1) : 1) + (fraction ? fraction + 1 : 0);
+        if (!positional) {
+            int exp10 = f.k - 1;
+            len += 2 + (exp10 <= -100 || exp10 >= 100 ? 3 : 2);
+        }
+    }
+
+#ifdef PICOFORMAT_HANDLE_FILL
+    bool fill_zeros = pSpec->flags.fill_zeros && '\0' != format;     // infinity and NaN are padded with spaces only
+    int padding = MAX(0, pSpec->whole_chars - len);
+    if (OUT_FULL(pOut)) {                           // only counting: no need to render the digits
+        pOut->cbCounted += len + padding;
+        return;
+    }
+    if (!pSpec->flags.left_align && !fill_zeros) {
+        out_fill(pOut, ' ', padding);
+    }
+#else  // PICOFORMAT_HANDLE_FILL
+    if (OUT_FULL(pOut)) {
+        pOut->cbCounted += len;
+        return;
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+    if ('\0' != chSign) {
+        out_putc(pOut, chSign);
+    }
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (!pSpec->flags.left_align && fill_zeros) {
+        out_fill(pOut, '0', padding);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+    if ('\0' == format) {
+        out_write(pOut, m ? (pSpec->flags.render_in_lowercase ? "nan" : "NAN") : (pSpec->flags.render_in_lowercase ? "inf" : "INF"), 3);
+    } else {
+        int index = 0;                              // of the next digit
+        if (positional) {
+            for (; index < f.k; index++) {
+                out_putc(pOut, float_digit(&f, index, shortest));
+            }
+            if (f.k <= 0) {
+                out_putc(pOut, '0');
+            }
+            index = f.k;
+        } else {
+            out_putc(pOut, float_digit(&f, index++, shortest));
+        }
+        if (fraction) {
+            out_putc(pOut, '.');
+            for (int end = index + fraction; index < end; index++) {
+                out_putc(pOut, float_digit(&f, index, shortest));
+            }
+        }
+        if (!positional) {
+            int exp10 = f.k - 1;
+            char pExp10[5] = { pExponent[0], exp10 < 0 ? '-' : '+' };
+            int cExp10 = 2;
+            exp10 = exp10 < 0 ? -exp10 : exp10;
+            if (exp10 >= 100) {
+                pExp10[cExp10++] = (char)('0' + exp10 / 100);
+            }
+            pExp10[cExp10++] = (char)('0' + exp10 / 10 % 10);
+            pExp10[cExp10++] = (char)('0' + exp10 % 10);
+            out_write(pOut, pExp10, cExp10);
+        }
+    }
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (pSpec->flags.left_align) {
+        out_fill(pOut, ' ', padding);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+}
+#endif // PICOFORMAT_HANDLE_FLOATS
+
+
+static void emit_char(pico_out *pOut, const pico_format_spec *pSpec, int ch) {
+    (void)pSpec;
+    out_putc(pOut, ch & 0xff);
+}
+
+
+// the layout of "%s": `*pPadBefore` chars `*pchPad`, then the first chars of `pStr` (returns their number), then
+// `*pPadAfter` spaces; shared with `pico_fmt_next()`, which hands it out across chunks
+static int string_layout(const pico_format_spec *pSpec, const char *pStr, int *pPadBefore, char *pchPad, int *pPadAfter) {
+    int whole_chars = pSpec->whole_chars;
+    int decimal_chars = pSpec->decimal_chars;
+    int len = 0;                                    // effective length, bounded by precision if set
+#ifdef PICOFORMAT_FAST_COPY
+    for (; (decimal_chars < 0 || len < decimal_chars) && len < FAST_COPY_MIN && pStr[len]; len++);
+    if (FAST_COPY_MIN == len && decimal_chars != len) {     // a longer string: the libc measures the rest
+        const char *pRest = pStr + len;             // memchr() stops at the precision: not a char past it is read
+        const char *pNull = decimal_chars < 0 ? pRest + strlen(pRest) : (const char *)memchr(pRest, '\0', decimal_chars - len);
+        len = pNull ? (int)(pNull - pStr) : decimal_chars;
+    }
+#else  // PICOFORMAT_FAST_COPY
+    for (; (decimal_chars < 0 || len < decimal_chars) && pStr[len]; len++);  // not a char past the precision is read
+#endif // PICOFORMAT_FAST_COPY
+    *pPadBefore = *pPadAfter = 0;
+    *pchPad = ' ';                                  // standard C: '0' flag is undefined for %s, use spaces
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (!pSpec->flags.left_align) {                 // right-align: pad on the left
+#ifdef PICOFORMAT_CLANG_QUIRK                       // clang's non-standard: '0' flag zero-pads strings
+        *pchPad = pSpec->flags.fill_zeros ? '0' : ' ';
+#endif // PICOFORMAT_CLANG_QUIRK
+        *pPadBefore = MAX(0, whole_chars - len);
+    } else {                                        // left-align: pad on the right (always spaces; '-' flag overrides '0')
+        *pPadAfter = MAX(0, whole_chars - len);
+    }
+#else  // PICOFORMAT_HANDLE_FILL
+    (void)whole_chars;
+#endif // PICOFORMAT_HANDLE_FILL
+    return len;
+}
+
+
+static void emit_string(pico_out *pOut, const pico_format_spec *pSpec, const char *pStr) {
+    int padBefore, padAfter;
+    char chPad;
+    int len = string_layout(pSpec, pStr, &padBefore, &chPad, &padAfter);
+#ifdef PICOFORMAT_HANDLE_FILL
+    out_fill(pOut, chPad, padBefore);
+#endif // PICOFORMAT_HANDLE_FILL
+    out_write(pOut, pStr, len);
+#ifdef PICOFORMAT_HANDLE_FILL
+    out_fill(pOut, ' ', padAfter);
+#endif // PICOFORMAT_HANDLE_FILL
+}
+
+
+// writes the decimal digits of `val` right-to-left, ending just before `pRight`; returns the first digit
+// the digits of "%d" and `pico_u32toa()` alike: only `wide` values take the 64-bit arithmetic with `PICOFORMAT_FAST_DECIMAL`
+static char *decimal_rtl(unsigned long long val, bool wide, char *pRight) {
+#ifdef PICOFORMAT_FAST_DECIMAL
+    return wide ? u64toa_rtl(val, pRight) : u32toa_rtl((unsigned)val, pRight);
+#else  // PICOFORMAT_FAST_DECIMAL
+    (void)wide;
+    do {                                            // right-to-left, so no flipping is needed
+        *--pRight = val % 10 + '0';
+        val /= 10;
+    } while (val);
+    return pRight;
+#endif // PICOFORMAT_FAST_DECIMAL
+}
+
+
+#ifdef PICOFORMAT_HANDLE_HEX
+// writes the hex digits of `val` right-to-left, ending just before `pRight`, at least `minDigits` of them (up to 16) with
+// the leading zeros; returns the first digit
+// all the 8 or 16 digits at once, then the leading zeros are skipped
+static char *hex_rtl(unsigned long long val, int minDigits, bool upper, char *pRight) {
+    char *pFirst = pRight - 8;
+    hex_u32(pFirst, (uint32_t)val, upper);
+    if (0 != (val >> 32) || minDigits > 8) {
+        hex_u32(pFirst -= 8, (uint32_t)(val >> 32), upper);
+    }
+    char *pLast = pRight - MAX(MIN(minDigits, 16), 1);
+    for (; pFirst < pLast && '0' == *pFirst; pFirst++);
+    return pFirst;
+}
+#endif // PICOFORMAT_HANDLE_HEX
+
+
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
+// binary, oct, or hex integer, always unsigned
+static void emit_radix(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val) {
+    int whole_chars = pSpec->whole_chars;
+    if (!pSpec->flags.treat_as_long) {
+        val = (unsigned)val;
+    }
+    int bits_per_digit = pSpec->bits_per_digit;
+    unsigned mask = (1u << bits_per_digit) - 1;
+#if defined(PICOFORMAT_HANDLE_HEX)
+    const char* chars = pSpec->flags.render_in_lowercase ? g_pLowercaseNumberDigits : g_pUppercaseNumberDigits;
+#elif defined(PICOFORMAT_HANDLE_OCT)
+    const char* chars = g_pOctalDigits;
+#else
+    const char* chars = g_pBinaryDigits;
+#endif // individual non-decimal formats
+    char pDigits[64];                               // enough for 64 binary digits
+    char *pFirst = pDigits + sizeof(pDigits);
+#ifdef PICOFORMAT_HANDLE_HEX
+    if (4 == bits_per_digit) {
+        int minDigits = 1;
+    #ifdef PICOFORMAT_HANDLE_FILL
+        if (pSpec->flags.fill_zeros && !pSpec->flags.left_align) {
+            minDigits = whole_chars;                // "%08x", "%016lx": the zeros are rendered along with the digits
+        }
+    #endif // PICOFORMAT_HANDLE_FILL
+        pFirst = hex_rtl(val, minDigits, !pSpec->flags.render_in_lowercase, pFirst);
+        emit_number(pOut, pSpec, whole_chars, '\0', pFirst, pDigits + sizeof(pDigits));
+        return;
+    }
+#endif // PICOFORMAT_HANDLE_HEX
+    do {                                            // right-to-left, so no flipping is needed
+        *--pFirst = chars[val & mask];
+        val >>= bits_per_digit;
+    } while (val);
+    emit_number(pOut, pSpec, whole_chars, '\0', pFirst, pDigits + sizeof(pDigits));
+}
+#endif // defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_HEX)
+
+
+// decimal integer: `val` is sign-extended when signed
+static void emit_decimal(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val) {
+    int whole_chars = pSpec->whole_chars;
+    char chSign = '\0';
+    char pDigits[20];                               // enough for 2^64 - 1
+    char *pFirst = pDigits + sizeof(pDigits);
+    if (!pSpec->flags.treat_as_unsigned) {          // magnitude only: `llabs()` overflows on the most negative value
+        long long int sval = pSpec->flags.treat_as_long ? (long long int)val : (int)val;
+        chSign = sval < 0 ? '-' : '\0';
+        val = sval < 0 ? 0ull - (unsigned long long int)sval : (unsigned long long int)sval;
+    } else if (!pSpec->flags.treat_as_long) {
+        val = (unsigned)val;
+    }
+    if ('\0' == chSign && pSpec->flags.force_sign) {
+        chSign = '+';
+    }
+#ifdef PICOFORMAT_FAST_DECIMAL
+    if (OUT_FULL(pOut)) {                           // only counting: the number of digits is all it takes
+        int len = count_digits(val) + ('\0' != chSign);
+    #ifdef PICOFORMAT_HANDLE_FILL
+        len = MAX(len, whole_chars);
+    #endif // PICOFORMAT_HANDLE_FILL
+        pOut->cbCounted += len;
+        return;
+    }
+#endif // PICOFORMAT_FAST_DECIMAL
+    // native 32-bit path unless 'l' is given: 32-bit cores never call the 64-bit division helpers
+    pFirst = decimal_rtl(val, pSpec->flags.treat_as_long, pFirst);
+    emit_number(pOut, pSpec, whole_chars, chSign, pFirst, pDigits + sizeof(pDigits));
+}
+
+
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+// writes the first `count` fraction digits of `rest` / 2^bits: times 10, the next digit is in the bits above the point
+// returns what is left of `rest`, still over 2^bits, for the rounding
+static unsigned long long fixed_digits(char *pDigits, int count, unsigned long long rest, int bits) {
+    if (bits <= 28) {                               // 10 * rest fits 32 bits: 32-bit cores need no 64-bit multiplication
+        uint32_t rest32 = (uint32_t)rest;
+        uint32_t mask32 = (1u << bits) - 1;
+        for (int ii = 0; ii < count; ii++) {
+            rest32 *= 10;
+            pDigits[ii] = (char)('0' + (rest32 >> bits));
+            rest32 &= mask32;
+        }
+        return rest32;
+    }
+    unsigned long long mask = (1ull << bits) - 1;  // up to 60 bits: 10 * rest still fits 64 bits
+    for (int ii = 0; ii < count; ii++) {
+        rest *= 10;
+        pDigits[ii] = (char)('0' + (rest >> bits));
+        rest &= mask;
+    }
+    return rest;
+}
+
+
+// fixed point "%Q<bits>": `val` (sign-extended when signed) over 2^bits, as exact as "%f" on the same value, rounded half-to-even
+// integer-only, without the float machinery: n fractional bits have at most n fraction digits, the rest are zeros
+static void emit_fixed(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val) {
+    int bits = pSpec->fraction_bits;
+    int fraction = pSpec->decimal_chars < 0 ? 6 : pSpec->decimal_chars;
+    long long int sval = pSpec->flags.treat_as_long ? (long long int)val : (int)val;
+    char chSign = sval < 0 ? '-' : pSpec->flags.force_sign ? '+' : '\0';
+    val = sval < 0 ? 0ull - (unsigned long long int)sval : (unsigned long long int)sval;
+    unsigned long long whole = val >> bits;
+    char pDigits[60];                               // the fraction digits that may not be zeros
+    int count = MIN(fraction, bits);
+    unsigned long long rest = fixed_digits(pDigits, count, val & ((1ull << bits) - 1), bits);
+    if (bits) {                                     // round half-to-even on the exact rest
+        unsigned long long half = 1ull << (bits - 1);
+        bool odd = count ? (pDigits[count - 1] & 1) : (whole & 1);  // '0' is even, too
+        if (rest > half || (rest == half && odd)) {
+            int ii = count - 1;
+            for (; ii >= 0 && '9' == pDigits[ii]; ii--) {
+                pDigits[ii] = '0';
+            }
+            if (ii >= 0) {
+                pDigits[ii]++;
+            } else {
+                whole++;
+            }
+        }
+    }
+    char pWhole[20];                                // enough for 2^64 - 1
+    char *pFirst = pWhole + sizeof(pWhole);
+    if (whole <= 0xffffffffu) {                     // 32-bit cores never call the 64-bit division helpers for a Q31
+        uint32_t whole32 = (uint32_t)whole;
+        do {
+            *--pFirst = whole32 % 10 + '0';
+            whole32 /= 10;
+        } while (whole32);
+    } else {
+        do {
+            *--pFirst = whole % 10 + '0';
+            whole /= 10;
+        } while (whole);
+    }
+    int len = ('\0' != chSign) + (int)(pWhole + sizeof(pWhole) - pFirst) + (fraction ? fraction + 1 : 0);
+
+    int padding = 0;
+#ifdef PICOFORMAT_HANDLE_FILL
+    padding = MAX(0, pSpec->whole_chars - len);
+    if (OUT_FULL(pOut)) {                           // only counting: no need to write the digits
+        pOut->cbCounted += len + padding;
+        return;
+    }
+    if (!pSpec->flags.left_align && !pSpec->flags.fill_zeros) {
+        out_fill(pOut, ' ', padding);
+    }
+#else  // PICOFORMAT_HANDLE_FILL
+    if (OUT_FULL(pOut)) {
+        pOut->cbCounted += len;
+        return;
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+    if ('\0' != chSign) {
+        out_putc(pOut, chSign);
+    }
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (!pSpec->flags.left_align && pSpec->flags.fill_zeros) {
+        out_fill(pOut, '0', padding);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+    out_write(pOut, pFirst, pWhole + sizeof(pWhole) - pFirst);
+    if (fraction) {
+        out_putc(pOut, '.');
+        out_write(pOut, pDigits, count);
+        for (int ii = count; ii < fraction; ii++) {
+            out_putc(pOut, '0');
+        }
+    }
+#ifdef PICOFORMAT_HANDLE_FILL
+    if (pSpec->flags.left_align) {
+        out_fill(pOut, ' ', padding);
+    }
+#endif // PICOFORMAT_HANDLE_FILL
+}
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+// hex dump: the width is the number of bytes
+static void emit_hexdump(pico_out *pOut, const pico_format_spec *pSpec, const void *pData) {
+    render_hexdump(pOut, (const unsigned char *)pData, (size_t)MAX(pSpec->whole_chars, 0), !pSpec->flags.render_in_lowercase, false);
+}
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+// floored division and the matching non-negative remainder: the timestamps before 1970 count backwards from the epoch too
+#define FLOOR_DIVMOD(val, divisor, pQuotient, pRemainder) { \
+        long long __quotient = (val) / (divisor), __remainder = (val) % (divisor); \
+        *(pQuotient) = __quotient - (__remainder < 0); \
+        *(pRemainder) = __remainder + (__remainder < 0) * (divisor); \
+    }
+
+static char *put_2digits(char *pDest, unsigned val) {
+    pDest[0] = (char)('0' + val / 10);
+    pDest[1] = (char)('0' + val % 10);
+    return pDest + 2;
+}
+
+
+// renders "YYYY-MM-DDThh:mm:ss" of `second` since the epoch; returns the end
+// the days to the proleptic Gregorian date are Howard Hinnant's `civil_from_days()`: 400-year eras of 146097 days, counted
+// from March, so that the leap day ends the year; no branch but the rare years out of 0000..9999
+static char *render_date_time(char *pDest, long long second) {
+    long long days, secondOfDay;
+    FLOOR_DIVMOD(second, 86400, &days, &secondOfDay);
+    long long era, dayOfEra;
+    FLOOR_DIVMOD(days + 719468, 146097, &era, &dayOfEra);   // 719468: the days from 0000-03-01 to 1970-01-01
+    unsigned doe = (unsigned)dayOfEra;
+    unsigned yearOfEra = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned dayOfYear = doe - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthFromMarch = (5 * dayOfYear + 2) / 153;
+    unsigned day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+    unsigned month = monthFromMarch + 3 - 12 * (monthFromMarch >= 10);
+    long long year = era * 400 + yearOfEra + (month <= 2);
+    if (year >= 0 && year <= 9999) {
+        pDest = put_2digits(put_2digits(pDest, (unsigned)year / 100), (unsigned)year % 100);
+    } else {                                        // the expanded years of ISO 8601: a sign, and at least 4 digits
+        char pDigits[20];
+        unsigned long long magnitude = year < 0 ? 0ull - (unsigned long long)year : (unsigned long long)year;
+        char *pFirst = decimal_rtl(magnitude, true, pDigits + sizeof(pDigits));
+        *pDest++ = year < 0 ? '-' : '+';
+        for (long long cDigits = pDigits + sizeof(pDigits) - pFirst; cDigits < 4; cDigits++) {
+            *pDest++ = '0';
+        }
+        for (; pFirst < pDigits + sizeof(pDigits); *pDest++ = *pFirst++);
+    }
+    *pDest++ = '-';
+    pDest = put_2digits(pDest, month);
+    *pDest++ = '-';
+    pDest = put_2digits(pDest, day);
+    *pDest++ = 'T';
+    unsigned seconds = (unsigned)secondOfDay;
+    pDest = put_2digits(pDest, seconds / 3600);
+    *pDest++ = ':';
+    pDest = put_2digits(pDest, seconds / 60 % 60);
+    *pDest++ = ':';
+    return put_2digits(pDest, seconds % 60);
+}
+
+
+#define TIMESTAMP_DATE_TIME_MAX 32              // "+292277026596-12-04T15:30:07", the furthest second of a 64-bit count
+
+#ifdef THREAD_LOCAL
+// the date and time of the last second rendered by this thread: the log lines of a same second re-render their fraction only
+typedef struct {
+    long long second;
+    unsigned char cbText;                       // 0 until the first timestamp
+    char pText[TIMESTAMP_DATE_TIME_MAX];
+} timestamp_cache;
+
+static THREAD_LOCAL timestamp_cache g_timestampCache;
+#endif // THREAD_LOCAL
+
+
+// "%T": RFC 3339 in UTC, e.g. "2024-05-17T12:34:56.123456Z", with as many digits of the fraction as the precision (6 if none,
+// up to 9), truncated rather than rounded, as the clocks are read; the width pads the whole timestamp, as with "%s"
+static void emit_timestamp(pico_out *pOut, const pico_format_spec *pSpec, long long second, long nanosecond) {
+    char pText[TIMESTAMP_DATE_TIME_MAX + 12];
+    char *pDest = pText;
+#ifdef THREAD_LOCAL
+    timestamp_cache *pCache = &g_timestampCache;
+    if (0 == pCache->cbText || second != pCache->second) {
+        pCache->cbText = (unsigned char)(render_date_time(pCache->pText, second) - pCache->pText);
+        pCache->second = second;
+    }
+    for (int ii = 0; ii < pCache->cbText; ii++) {
+        *pDest++ = pCache->pText[ii];
+    }
+#else  // THREAD_LOCAL
+    pDest = render_date_time(pDest, second);
+#endif // THREAD_LOCAL
+    int cFraction = pSpec->decimal_chars < 0 ? 6 : MIN(pSpec->decimal_chars, 9);
+    if (cFraction) {
+        *pDest++ = '.';
+        unsigned fraction = (unsigned)nanosecond;
+        for (int ii = 9; ii > cFraction; ii--) {
+            fraction /= 10;
+        }
+        for (int ii = cFraction; ii > 0; ii--) {
+            pDest[ii - 1] = (char)('0' + fraction % 10);
+            fraction /= 10;
+        }
+        pDest += cFraction;
+    }
+    *pDest++ = 'Z';
+    *pDest = '\0';
+    pico_format_spec padded = *pSpec;               // the precision is taken: the whole string is rendered, with spaces only
+    padded.decimal_chars = -1;
+    padded.flags.fill_zeros = 0;
+    emit_string(pOut, &padded, pText);
+}
+
+
+// splits nanoseconds since the epoch, e.g. of "%lT", into the second and its fraction
+static void emit_timestamp_ns(pico_out *pOut, const pico_format_spec *pSpec, long long ns) {
+    long long second, nanosecond;
+    FLOOR_DIVMOD(ns, 1000000000, &second, &nanosecond);
+    emit_timestamp(pOut, pSpec, second, (long)nanosecond);
+}
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+
+
+// `pSpec` with its '*' width and precision read from `pvl`, into `pResolved` if it has any
+static const pico_format_spec *resolve_spec(const pico_format_spec *pSpec, pico_format_spec *pResolved, va_list *pvl) {
+    if (pSpec->flags.whole_from_arg || pSpec->flags.decimal_from_arg) {
+        *pResolved = *pSpec;
+        pResolved->whole_chars = pSpec->flags.whole_from_arg ? va_arg(*pvl, int) : pSpec->whole_chars;
+        pResolved->decimal_chars = pSpec->flags.decimal_from_arg ? va_arg(*pvl, int) : pSpec->decimal_chars;
+        return pResolved;
+    }
+    return pSpec;
+}
+
+
+// renders a single parsed conversion, reading its arguments (including the '*' width and precision) from `pvl`
+static void render_spec(pico_out *pOut, const pico_format_spec *pSpec, va_list *pvl) {
+    pico_format_spec resolved;
+    pSpec = resolve_spec(pSpec, &resolved, pvl);
+    switch (pSpec->format) {
+    case 'c':           // single char
+        emit_char(pOut, pSpec, va_arg(*pvl, int));
+        break;
+    case 's':           // null-terminated string
+        emit_string(pOut, pSpec, va_arg(*pvl, const char*));
+        break;
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
+    case 'b':           // binary, oct, or hex integer, always unsigned
+        emit_radix(pOut, pSpec, pSpec->flags.treat_as_long ? va_arg(*pvl, unsigned long long int) : va_arg(*pvl, unsigned));
+        break;
+#endif // defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_HEX)
+    case 'd':           // decimal integer
+    case 'i':
+        if (pSpec->flags.treat_as_long) {
+            emit_decimal(pOut, pSpec, va_arg(*pvl, unsigned long long int));
+        } else if (pSpec->flags.treat_as_unsigned) {
+            emit_decimal(pOut, pSpec, va_arg(*pvl, unsigned));
+        } else {
+            emit_decimal(pOut, pSpec, (unsigned long long int)(long long int)va_arg(*pvl, int));
+        }
+        break;
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+    case 'H':
+        emit_hexdump(pOut, pSpec, va_arg(*pvl, const void *));
+        break;
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+    case 'Q':           // fixed point: read as the integers of "%d" are
+        emit_fixed(pOut, pSpec, pSpec->flags.treat_as_long ? va_arg(*pvl, unsigned long long int) : (unsigned long long int)(long long int)va_arg(*pvl, int));
+        break;
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+#ifdef PICOFORMAT_HANDLE_FLOATS
+    case 'f': case 'F':
+    case 'e': case 'E':
+    case 'g': case 'G':
+    case 'r':
+        emit_double(pOut, pSpec, va_arg(*pvl, double));
+        break;
+#endif // PICOFORMAT_HANDLE_FLOATS
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+    case 'T':           // nanoseconds since the epoch with 'l', or else a `struct timespec *`
+        if (pSpec->flags.treat_as_long) {
+            emit_timestamp_ns(pOut, pSpec, va_arg(*pvl, long long int));
+        } else {
+            const struct timespec *pTime = va_arg(*pvl, const struct timespec *);
+            emit_timestamp(pOut, pSpec, (long long)pTime->tv_sec, (long)pTime->tv_nsec);
+        }
+        break;
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+    default: {          // a registered conversion, unless it was unregistered since the format was compiled, or none was parsed
+        pico_conversion_fn handler = pSpec->format >= 'A' && pSpec->format <= 'z' ? g_pConversions[pSpec->format - 'A'] : NULL;
+        if (handler) {
+            handler(pOut, pSpec, pvl);
+        }
+        break;
+    }
+#endif // PICOFORMAT_HANDLE_CUSTOM
+    }
+}
+
+
+// the kernels for the callers that parse the formats on their own (e.g. picoprintf.hpp)
+// thin wrappers: the interpreter calls the static kernels directly, for the compiler to be free to inline them
+void pico_emit_literal(pico_out *pOut, const char *pSrc, size_t cbSrc) {
+    out_write(pOut, pSrc, cbSrc);
+}
+
+
+void pico_emit_char(pico_out *pOut, const pico_format_spec *pSpec, int ch) {
+    emit_char(pOut, pSpec, ch);
+}
+
+
+void pico_emit_string(pico_out *pOut, const pico_format_spec *pSpec, const char *pStr) {
+    emit_string(pOut, pSpec, pStr);
+}
+
+
+void pico_emit_decimal(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val) {
+    emit_decimal(pOut, pSpec, val);
+}
+
+
+#if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
+void pico_emit_radix(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val) {
+    emit_radix(pOut, pSpec, val);
+}
+#endif // defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_HEX)
+
+
+#ifdef PICOFORMAT_HANDLE_FLOATS
+void pico_emit_double(pico_out *pOut, const pico_format_spec *pSpec, double val) {
+    emit_double(pOut, pSpec, val);
+}
+#endif // PICOFORMAT_HANDLE_FLOATS
+
+
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+void pico_emit_fixed(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val) {
+    emit_fixed(pOut, pSpec, val);
+}
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+void pico_emit_hexdump(pico_out *pOut, const pico_format_spec *pSpec, const void *pData) {
+    emit_hexdump(pOut, pSpec, pData);
+}
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+void pico_emit_timestamp(pico_out *pOut, const pico_format_spec *pSpec, long long ns) {
+    emit_timestamp_ns(pOut, pSpec, ns);
+}
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+
+
+// copies `chSign` (unless '\0') and [pFirst, pLast) to `pDest`: returns the end, or NULL if it does not fit before `pEnd`
+static char *copy_number(char *pDest, char *pEnd, char chSign, const char *pFirst, const char *pLast) {
+    if ((pLast - pFirst) + ('\0' != chSign) > pEnd - pDest) {
+        return NULL;
     }
+    if ('\0' != chSign) {
+        *pDest++ = chSign;
+    }
+    while (pFirst < pLast) {
+        *pDest++ = *pFirst++;
+    }
+    return pDest;
 }
 
-// using #define over `inline` for enabling porting to old C
-#if !defined(MIN)
-#define MIN(left, right) (((left) < (right)) ? (left) : (right))
-#endif
-#if !defined(MAX)
-#define MAX(left, right) (((left) > (right)) ? (left) : (right))
-#endif
+
+// the typed kernels: the same digits as the conversions of `pico_snprintf()`, without the format, the `va_list` and the `pico_out`
+char *pico_u32toa(char *pDest, char *pEnd, uint32_t val) {
+    char pDigits[10];
+    return copy_number(pDest, pEnd, '\0', decimal_rtl(val, false, pDigits + sizeof(pDigits)), pDigits + sizeof(pDigits));
+}
 
 
-// returns the pointer to the null-terminating character of the filled string
-int pico_vsnprintf(char *pDest, size_t cbDest, const char *pFormat, va_list vl) {
-    const char *pLowercaseNumberDigits = "0123456789abcdef";
-    const char *pUppercaseNumberDigits = "0123456789ABCDEF";
-    const char *pOctalDigits = pLowercaseNumberDigits;
-    const char *pBinaryDigits = pLowercaseNumberDigits;
-    char *pStart = pDest;
-    for (char *pEnd = pDest + cbDest - 1; *pFormat && pDest < pEnd; ) {
+char *pico_u64toa(char *pDest, char *pEnd, uint64_t val) {
+    char pDigits[20];
+    return copy_number(pDest, pEnd, '\0', decimal_rtl(val, val >> 32, pDigits + sizeof(pDigits)), pDigits + sizeof(pDigits));
+}
+
+
+char *pico_i64toa(char *pDest, char *pEnd, int64_t val) {
+    char pDigits[20];
+    uint64_t magnitude = val < 0 ? 0ull - (uint64_t)val : (uint64_t)val;   // `llabs()` overflows on the most negative value
+    char *pFirst = decimal_rtl(magnitude, magnitude >> 32, pDigits + sizeof(pDigits));
+    return copy_number(pDest, pEnd, val < 0 ? '-' : '\0', pFirst, pDigits + sizeof(pDigits));
+}
+
+
+#ifdef PICOFORMAT_HANDLE_HEX
+char *pico_xtoa(char *pDest, char *pEnd, uint64_t val, int width, int upper) {
+    char pDigits[16];
+    char *pFirst = hex_rtl(val, width, upper, pDigits + sizeof(pDigits));
+    for (int zeros = width - (int)(pDigits + sizeof(pDigits) - pFirst); zeros > 0; zeros--) {  // wider than 16 digits
+        if (pDest == pEnd) {
+            return NULL;
+        }
+        *pDest++ = '0';
+    }
+    return copy_number(pDest, pEnd, '\0', pFirst, pDigits + sizeof(pDigits));
+}
+#endif // PICOFORMAT_HANDLE_HEX
+
+
+#ifdef PICOFORMAT_HANDLE_FLOATS
+char *pico_ftoa(char *pDest, char *pEnd, double val, int precision) {
+    pico_format_spec spec = {0};
+    spec.format = 'f';
+    spec.decimal_chars = precision;
+    spec.flags.render_in_lowercase = 1;
+    pico_out out = { pDest, pEnd, pDest };
+    emit_double(&out, &spec, val);
+    return OUT_TOTAL(&out) > (size_t)(pEnd - pDest) ? NULL : out.pDest;
+}
+#endif // PICOFORMAT_HANDLE_FLOATS
+
+
+char *pico_strpad(char *pDest, char *pEnd, const char *pStr, int width) {
+    size_t len = 0;
+    for (; pStr[len]; len++);
+    size_t cbPadding = (size_t)(width < 0 ? -(long long)width : width);
+    cbPadding = cbPadding > len ? cbPadding - len : 0;
+    if (len + cbPadding > (size_t)(pEnd - pDest)) {
+        return NULL;
+    }
+    for (size_t ii = 0; width > 0 && ii < cbPadding; ii++) {
+        *pDest++ = ' ';
+    }
+    for (size_t ii = 0; ii < len; ii++) {
+        *pDest++ = pStr[ii];
+    }
+    for (size_t ii = 0; width < 0 && ii < cbPadding; ii++) {
+        *pDest++ = ' ';
+    }
+    return pDest;
+}
+
+
+#ifdef PICOFORMAT_STATS
+static pico_stats g_pStatsSlots[PICOFORMAT_STATS_THREADS];
+static unsigned g_cStatsThreads;            // the slots claimed so far: past `PICOFORMAT_STATS_THREADS`, the threads share the last one
+
+#if PICOFORMAT_STATS_THREADS > 1
+#ifndef THREAD_LOCAL
+#error "PICOFORMAT_STATS requires thread-local storage: C11, or the __thread of gcc and clang (or PICOFORMAT_STATS_THREADS 1)"
+#endif // THREAD_LOCAL
+#if !defined(__GNUC__)
+#error "PICOFORMAT_STATS requires the __atomic builtins of gcc or clang (or PICOFORMAT_STATS_THREADS 1)"
+#endif // __GNUC__
+
+static THREAD_LOCAL pico_stats *g_pThreadStats;
+
+// the slot of the calling thread, claimed by its first call
+static pico_stats *thread_stats(void) {
+    if (!g_pThreadStats) {
+        unsigned slot = __atomic_fetch_add(&g_cStatsThreads, 1, __ATOMIC_RELAXED);
+        g_pThreadStats = &g_pStatsSlots[MIN(slot, PICOFORMAT_STATS_THREADS - 1)];
+    }
+    return g_pThreadStats;
+}
+
+// adds `n` to `counter` of `pStats`: atomically in the last slot, which the threads past `PICOFORMAT_STATS_THREADS` share,
+// so that only they pay for it; the other slots have a single writer
+#define STATS_SHARED_SLOT (&g_pStatsSlots[PICOFORMAT_STATS_THREADS - 1])
+#define STATS_ADD(pStats, counter, n) ((pStats) == STATS_SHARED_SLOT \
+    ? (void)__atomic_fetch_add(&(pStats)->counter, (n), __ATOMIC_RELAXED) : (void)((pStats)->counter += (n)))
+#define STATS_LOAD(pStats, counter) ((pStats) == STATS_SHARED_SLOT \
+    ? __atomic_load_n(&(pStats)->counter, __ATOMIC_RELAXED) : (pStats)->counter)
+#else  // PICOFORMAT_STATS_THREADS
+static pico_stats *thread_stats(void) {
+    g_cStatsThreads = 1;
+    return g_pStatsSlots;
+}
+
+#define STATS_ADD(pStats, counter, n) ((pStats)->counter += (n))
+#define STATS_LOAD(pStats, counter) ((pStats)->counter)
+#endif // PICOFORMAT_STATS_THREADS
+
+
+// the counters of a whole call, once its length is known
+static void stats_count_call(size_t cbTotal, bool truncated) {
+    pico_stats *pStats = thread_stats();
+    STATS_ADD(pStats, calls, 1);
+    STATS_ADD(pStats, bytes, cbTotal);
+    STATS_ADD(pStats, truncations, truncated);
+    int bucket = 0;
+    for (size_t rest = cbTotal >> 4; rest && bucket < PICO_STATS_LENGTHS - 1; rest >>= 1, bucket++);
+    STATS_ADD(pStats, lengths[bucket], 1);
+}
+
+// counts a conversion by its char as written, which ends at `pNext`: the digits of "%Q16" follow it
+static void stats_count_conversion(pico_stats *pStats, const pico_format_spec *pSpec, const char *pNext) {
+    char conversion = 'Q' == pSpec->format ? 'Q' : pNext[-1];
+    if ('\0' != pSpec->format && conversion >= 'A' && conversion <= 'z') {
+        STATS_ADD(pStats, conversions[conversion - 'A'], 1);
+    }
+}
+
+// charges the ticks since the previous split to `counter` of `pStats`: the locals of `format()`
+#define STATS_SPLIT(counter) (now = PICOFORMAT_STATS_CLOCK(), STATS_ADD(pStats, counter, now - ticks), ticks = now)
+#else  // PICOFORMAT_STATS
+#define STATS_SPLIT(counter)
+#endif // PICOFORMAT_STATS
+
+
+// the interpreter shared by all the entry points
+static void format(pico_out *pOut, const char *pFormat, va_list *pvl) {
+#ifdef PICOFORMAT_STATS
+    pico_stats *pStats = thread_stats();
+    uint64_t ticks = PICOFORMAT_STATS_CLOCK(), now;
+#endif // PICOFORMAT_STATS
+    while (*pFormat) {
         if (*pFormat != '%') {
-            *pDest++ = *pFormat++;
+            pFormat = out_literal(pOut, pFormat);
         } else {                            // format starts here
             pFormat++;                      // skipping the '%'
             if (*pFormat == '%') {          // unless it's indeed a '%'
-                *pDest++ = *pFormat++;
-            } else {                        // first, collect the format
-                char format = '\0';
-                int bits_per_digit = 0;     // valid in 'b', 'o', 'p' and 'x'/'X' modes only
-                int whole_chars = 0;        // number of chars in the whole part of the number
-                int decimal_chars = -1;     // if not specified, %f are rendered with 6, while %g are rendered with 0
-            #ifdef __aarch64__              // these platforms benefit from packing flags into a single variable
-                struct {
-                    unsigned force_sign:1;
-                    unsigned fill_zeros:1;
-                    unsigned left_align:1;
-                    unsigned seen_period:1;
-                    unsigned seen_numbers:1;
-                    unsigned treat_as_unsigned:1;
-                    unsigned treat_as_long:1;
-                    unsigned render_in_lowercase:1;
-                } flags = {0};
-                #define FLAGS flags.
-
-            #else                           // other platforms do not benefit from struct packing
-                unsigned force_sign = 0;
-                unsigned fill_zeros = 0;
-                unsigned left_align = 0;
-                unsigned seen_period = 0;
-                unsigned seen_numbers = 0;
-                unsigned treat_as_unsigned = 0;
-                unsigned treat_as_long = 0;
-                unsigned render_in_lowercase = 0;
-                #define FLAGS
-            #endif                          // struct packing platforms
-                for (; *pFormat && '\0' == format; pFormat++) {
-                    switch (*pFormat) {
-                #ifdef PICOFORMAT_HANDLE_FORCEDSIGN
-                    case '+':
-                        FLAGS force_sign = 1;
-                        break;
-                #endif // PICOFORMAT_HANDLE_FORCEDSIGN
-                #ifdef PICOFORMAT_HANDLE_FILL
-                    case '-':    // left-align flag
-                        FLAGS left_align = 1;
-                        break;
-                #endif // PICOFORMAT_HANDLE_FILL
-                    case '0':
-                        if (!FLAGS seen_numbers) {
-                            FLAGS fill_zeros = 1;
-                            break;
-                        }
-                        // fall through
-                    case '1':
-                    case '2':
-                    case '3':
-                    case '4':
-                    case '5':
-                    case '6':
-                    case '7':
-                    case '8':
-                    case '9':
-                        *(FLAGS seen_period ? &decimal_chars : &whole_chars ) *= 10;
-                        *(FLAGS seen_period ? &decimal_chars : &whole_chars) += *pFormat - '0';
-                        FLAGS seen_numbers = 1;
-                        break;
-                    case '.':
-                        FLAGS seen_numbers = FLAGS seen_period = 1;
-                        decimal_chars = 0;
-                        break;
-                    case '*':                        // dynamic width/precision: read value from arg list
-                        *(FLAGS seen_period ? &decimal_chars : &whole_chars) = va_arg(vl, int);
-                        FLAGS seen_numbers = 1;
-                        break;
-                    case 'l':    // long modifier
-                        FLAGS treat_as_long = 1;
-                        break;
-                    case 'u':    // unsigned decimal integer
-                        FLAGS treat_as_unsigned = 1;
-                        format = 'd';
-                        break;
-                #ifdef PICOFORMAT_HANDLE_BIN
-                    case 'b':
-                        bits_per_digit = 0;
-                        FLAGS treat_as_unsigned = 1;
-                        format = 'b';
-                        break;
-                #endif // PICOFORMAT_HANDLE_BIN
-                #ifdef PICOFORMAT_HANDLE_OCT
-                    case 'o':    // octal integer
-                        bits_per_digit = 3;
-                        FLAGS treat_as_unsigned = 1;
-                        format = 'b';
-                        break;
-                #endif // PICOFORMAT_HANDLE_OCT
-                #ifdef PICOFORMAT_HANDLE_HEX
-                    case 'x':    // hexadecimal integer
-                    case 'p':    // pointer
-                        bits_per_digit = 4;
-                        FLAGS treat_as_unsigned = 1;
-                        FLAGS render_in_lowercase = 1;
-                        format = 'b';
-                        break;
-                    case 'X':    // hexadecimal integer, uppercase
-                        bits_per_digit = 4;
-                        FLAGS treat_as_unsigned = 1;
-                        format = 'b';
-                        break;
-                #endif // PICOFORMAT_HANDLE_HEX
-                #ifdef PICOFORMAT_HANDLE_FLOATS
-                    case 'a':
-                #ifdef PICOFORMAT_HANDLE_EXPONENTS
-                    case 'e':   // floating point, exponent format
-                #endif // PICOFORMAT_HANDLE_EXPONENTS
-                    case 'f':
-                        FLAGS render_in_lowercase = 1;
-                        // fall through
-                    case 'F':
-                #endif // PICOFORMAT_HANDLE_FLOATS
-                    case 'c':  // single char: always supported
-                    case 'd':  // integer: always supported
-                    case 'i':  // integer: always supported
-                    case 's':  // string of native `char`s: always supported
-                        format = *pFormat;
-                        break;
-                    default:
-                        FORMAT_ERROR_DELEGATE("detected unhandled format specifier: %c", *pFormat);
-                        break;
-                    }
-                }
-
-                // format is parsed, now render the value
-                char *pParamStarts = pDest;
-                switch (format) {
-                case 'c':           // single char
-                    *pDest++ = va_arg(vl, int) & 0xff;
-                    break;
-                case 's': {         // null-terminated string
-                #ifdef PICOFORMAT_HANDLE_FILL
-                        int len = 0;                                // effective length, bounded by precision if set
-                        const char *pStr = va_arg(vl, const char*);
-                        for (; pStr[len] && (decimal_chars < 0 || len < decimal_chars); len++);
-                        if (!FLAGS left_align) {                    // right-align: pad on the left
-                #ifdef PICOFORMAT_CLANG_QUIRK                       // clang's non-standard: '0' flag zero-pads strings
-                            char chFill = FLAGS fill_zeros ? '0' : ' ';
-                #else  // PICOFORMAT_CLANG_QUIRK                     // standard C: '0' flag is undefined for %s, use spaces
-                            char chFill = ' ';
-                #endif // PICOFORMAT_CLANG_QUIRK
-                            for (; pDest < pEnd && whole_chars > len; whole_chars--) {
-                                *pDest++ = chFill;
-                            }
-                        }
-                        for (int ii = 0; ii < len && pDest < pEnd; ii++) {
-                            *pDest++ = pStr[ii];
-                        }
-                        if (FLAGS left_align) {                     // left-align: pad on the right (always spaces; '-' flag overrides '0')
-                            for (; pDest < pEnd && whole_chars > len; whole_chars--) {
-                                *pDest++ = ' ';
-                            }
-                        }
-                #else  // PICOFORMAT_HANDLE_FILL
-                        for (const char *pStr = va_arg(vl, const char*); *pStr && pDest < pEnd; ) {
-                            *pDest++ = *pStr++;
-                        }
-                #endif // PICOFORMAT_HANDLE_FILL
-                    }
-                    break;
-            #if defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
-                case 'b': {          // binary, oct, or hex integer, always unsigned
-                        long long int val = 0;
-                        if (FLAGS treat_as_long) {
-                            val = va_arg(vl, unsigned long long int);
-                        } else {
-                            val = va_arg(vl, unsigned);
-                        }
-                        unsigned mask = bits_per_digit == 4 ? 0x0f : bits_per_digit == 3 ? 0x07 : 0x01;
-                #if defined(PICOFORMAT_HANDLE_HEX)
-                        const char* chars = FLAGS render_in_lowercase ? pLowercaseNumberDigits : pUppercaseNumberDigits;
-                #elif defined(PICOFORMAT_HANDLE_OCT)
-                        const char* chars = pOctalDigits;
-                #else
-                        const char* chars = pBinaryDigits;
-                #endif // individual non-decimal formats
-                        while (pDest < pEnd
-                            && (pDest == pParamStarts
-                             || val
-                             || pDest - pParamStarts < whole_chars)) {
-                            char ch;
-                            if (pDest == pParamStarts || 0 != val) { // if first char or there's still meaningful digits
-                                ch = chars[val & mask];
-                                val >>= bits_per_digit;
-                            } else {
-                                ch = FLAGS fill_zeros ? '0' : ' ';
-                            }
-                            *pDest++ = ch;
-                        }
-                        flip(pParamStarts, pDest);
-                    }
-                    break;
-            #endif // defined(PICOFORMAT_HANDLE_BIN) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_HEX)
-                case 'd':           // decimal integer
-                case 'i': {
-                        long long int val = 0;
-                        if (FLAGS treat_as_long) {
-                            if (FLAGS treat_as_unsigned) {
-                                val = va_arg(vl, unsigned long long int);
-                            } else {
-                                val = va_arg(vl, long long int);
-                            }
-                        } else {
-                            if (FLAGS treat_as_unsigned) {
-                                val = va_arg(vl, unsigned);
-                            } else {
-                                val = va_arg(vl, int);
-                            }
-                        }
-                        char chSign = '\0';
-                        if ((FLAGS force_sign || val < 0) && pDest < pEnd) {
-                            chSign = val < 0 ? '-' : '+';
-                            val = llabs(val);
-                            whole_chars--;
-                        }
-                        while (pDest < pEnd
-                            && (pDest == pParamStarts
-                             || val
-                             || pDest - pParamStarts < whole_chars)) {
-                            char ch;
-                            if (pDest == pParamStarts || 0 != val) {        // if first digit (i.e. zero) or there's still non-zero digits to write
-                                ch = val % 10 + '0';
-                                val /= 10;
-                            } else {
-                                if ('\0' != chSign && !FLAGS fill_zeros) {  // write a sign if filling with spaces, not with zeros
-                                    *pDest++ = chSign;
-                                    whole_chars++;
-                                    chSign = '\0';                          // prevent the sign from being written twice
-                                }
-                        #ifdef PICOFORMAT_HANDLE_FILL
-                                ch = FLAGS fill_zeros ? '0' : ' ';
-                        #else // PICOFORMAT_HANDLE_FILL
-                                    break;
-                        #endif // PICOFORMAT_HANDLE_FILL
-                            }
-                            *pDest++ = ch;
-                        }
-                        if ('\0' != chSign) {                               // write a sign if it wasn't written before
-                            *pDest++ = chSign;
-                        }
-                        flip(pParamStarts, pDest);
-                    }
-                    break;
-            #ifdef PICOFORMAT_HANDLE_FLOATS
-                case 'f': case 'F': {
-                        double val = va_arg(vl, double);
-                        if (FLAGS force_sign || val < 0.f) {
-                            *pDest++ = val < 0.f ? '-' : '+';
-                            val = fabs(val);
-                            pParamStarts = pDest;
-                        }
-                        if (val == INFINITY || val == -INFINITY || isnan(val)) {
-                            for (const char *pszVal = isnan(val) ? FLAGS render_in_lowercase ? "nan" : "NAN": FLAGS render_in_lowercase ? "inf" : "INF"
-                               ; pDest < pEnd && *pszVal
-                               ; *pDest++ = *pszVal++);
-                        } else {
-                            if (decimal_chars == -1) {
-                                if (format == 'g') {
-                                    decimal_chars = 0;
-                                } else {
-                                    decimal_chars = 6;
-                                }
-                            }
-                            whole_chars = MAX(0, whole_chars - decimal_chars);
-                            whole_chars = MAX(whole_chars, pDest - pParamStarts + 1); // at least sign (if present) and first char
-                            for (float digit = 1.f
-                               ; pDest < pEnd && (val >= digit || pDest - pParamStarts < whole_chars)
-                               ; digit *= 10.f) {
-                                char ch = (int)(val / digit) % 10 + '0';
-                                *pDest++ = ch;
-                            }
-                            flip(pParamStarts, pDest);
-                            if (decimal_chars && pDest < pEnd) {
-                                *pDest++ = '.';
-                                val += .5f * pow(10.f, -decimal_chars); // compensating for rounding error
-                                for (size_t digit = 0; pDest < pEnd && digit < decimal_chars; digit++) {
-                                    val = (val - (int)(val)) * 10.f;
-                                    *pDest++ = (int)(val) + '0';
-                                }
-                            }
-                        }
-                    }
-                    break;
-            #endif // PICOFORMAT_HANDLE_FLOATS
-                }
+                out_putc(pOut, *pFormat++);
+            } else {                        // first, collect the format, then render the value
+                pico_format_spec spec;
+                pFormat = parse_spec(pFormat, &spec);
+#ifdef PICOFORMAT_STATS
+                stats_count_conversion(pStats, &spec, pFormat);
+#endif // PICOFORMAT_STATS
+                STATS_SPLIT(parse_ticks);
+                render_spec(pOut, &spec, pvl);
+                STATS_SPLIT(render_ticks);
             }
         }
     }
-    *pDest = '\0';
-    return pDest - pStart;
+    STATS_SPLIT(parse_ticks);
+}
+
+
+// returns the number of chars the whole output takes (not counting the null-terminator), even if it was truncated
+int pico_vsnprintf(char *pDest, size_t cbDest, const char *pFormat, va_list vl) {
+    pico_out out = { pDest, cbDest ? pDest + cbDest - 1 : pDest, pDest };
+    va_list vlCopy;                         // `va_arg()` is only portable on a pointer to a local `va_list`
+    va_copy(vlCopy, vl);
+    format(&out, pFormat, &vlCopy);
+    va_end(vlCopy);
+    if (cbDest) {
+        *out.pDest = '\0';
+    }
+#ifdef PICOFORMAT_STATS
+    stats_count_call(OUT_TOTAL(&out), cbDest && OUT_TOTAL(&out) >= cbDest);
+#endif // PICOFORMAT_STATS
+    return (int)OUT_TOTAL(&out);
+}
+
+
+int pico_vmeasure(const char *pFormat, va_list vl) {
+    return pico_vsnprintf(NULL, 0, pFormat, vl);
+}
+
+
+int pico_measure(const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    int result = pico_vsnprintf(NULL, 0, pFormat, vl);
+    va_end(vl);
+    return result;
+}
+
+
+int pico_vfctprintf(pico_flush_fn flush, void *pCtx, const char *pFormat, va_list vl) {
+    char pChunk[2 * PICOFORMAT_CHUNK_SIZE]; // two halves: one is filled while the other one is being transmitted
+    pico_out out = { pChunk, pChunk + PICOFORMAT_CHUNK_SIZE, pChunk, flush, pCtx, pChunk + PICOFORMAT_CHUNK_SIZE };
+    va_list vlCopy;
+    va_copy(vlCopy, vl);
+    format(&out, pFormat, &vlCopy);
+    va_end(vlCopy);
+    out_flush(&out);
+#ifdef PICOFORMAT_STATS
+    stats_count_call(out.cbCounted, false);
+#endif // PICOFORMAT_STATS
+    return (int)out.cbCounted;
+}
+
+
+int pico_fctprintf(pico_flush_fn flush, void *pCtx, const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    int result = pico_vfctprintf(flush, pCtx, pFormat, vl);
+    va_end(vl);
+    return result;
+}
+
+
+// the destination of a conversion rendered again: its first `cbSkip` chars were handed out by the previous chunks
+typedef struct {
+    char *pDest;
+    char *pEnd;
+    size_t cbSkip;
+} cut_ctx;
+
+static void cut_flush(void *pCtx, const char *pSrc, size_t cbSrc) {
+    cut_ctx *pCut = (cut_ctx *)pCtx;
+    size_t cbSkipped = MIN(pCut->cbSkip, cbSrc);
+    pCut->cbSkip -= cbSkipped;
+    for (size_t ii = cbSkipped; ii < cbSrc && pCut->pDest < pCut->pEnd; ii++) {
+        *pCut->pDest++ = pSrc[ii];
+    }
+}
+
+
+// 'r': renders the cut conversion once more, from its arguments on, through a chunk on the stack (as `pico_vfctprintf()`
+// does): only the chars past the ones already handed out land in `pOut`, which may cut it again
+// the fallback of the conversions longer than `PICOFORMAT_RESUME_SIZE`: each chunk renders them whole
+static void resume_render(pico_fmt_state *pState, pico_out *pOut) {
+    char pChunk[2 * PICOFORMAT_CHUNK_SIZE];
+    cut_ctx ctx = { pOut->pDest, pOut->pEnd, pState->cbSrc };
+    pico_out out = { pChunk, pChunk + PICOFORMAT_CHUNK_SIZE, pChunk, cut_flush, &ctx, pChunk + PICOFORMAT_CHUNK_SIZE };
+    pico_format_spec spec;
+    parse_spec(pState->pSrc + 1, &spec);
+    va_list vlCut;
+    va_copy(vlCut, pState->vlCut);
+    render_spec(&out, &spec, &vlCut);
+    va_end(vlCut);
+    out_flush(&out);
+    size_t cbCopied = ctx.pDest - pOut->pDest;
+    pOut->pDest = ctx.pDest;
+    if (out.cbCounted > pState->cbSrc + cbCopied) {
+        pState->cbSrc += cbCopied;
+    } else {
+        va_end(pState->vlCut);
+        pState->cut = '\0';
+    }
+}
+
+
+// 's': hands out as much of the rest of the span as fits `pOut`: the padding before it, its chars, and the padding after it
+static void resume_span(pico_fmt_state *pState, pico_out *pOut) {
+#ifdef PICOFORMAT_HANDLE_FILL
+    int cPad = (int)MIN((size_t)pState->cPadBefore, (size_t)(pOut->pEnd - pOut->pDest));
+    out_fill(pOut, pState->chPad, cPad);
+    pState->cPadBefore -= cPad;
+#endif // PICOFORMAT_HANDLE_FILL
+    size_t cbSpan = MIN(pState->cbSrc, (size_t)(pOut->pEnd - pOut->pDest));
+    out_write(pOut, pState->pSrc, cbSpan);
+    pState->pSrc += cbSpan;
+    pState->cbSrc -= cbSpan;
+#ifdef PICOFORMAT_HANDLE_FILL
+    cPad = (int)MIN((size_t)pState->cPadAfter, (size_t)(pOut->pEnd - pOut->pDest));
+    out_fill(pOut, ' ', cPad);
+    pState->cPadAfter -= cPad;
+#endif // PICOFORMAT_HANDLE_FILL
+    if (!pState->cPadBefore && !pState->cbSrc && !pState->cPadAfter) {
+        pState->cut = '\0';
+    }
+}
+
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+// 'H': hands out as many of the hex digits of the bytes left as fit `pOut`, which may cut a byte between its two digits
+static void resume_hexdump(pico_fmt_state *pState, pico_out *pOut) {
+    const unsigned char *pSrc = (const unsigned char *)pState->pSrc;
+    bool upper = 'A' == pState->chPad;
+    char pDigits[2];
+    if (pState->cPadBefore && pOut->pDest < pOut->pEnd) {  // the low digit of a byte cut by the previous chunk
+        hex_bytes(pDigits, pSrc++, 1, upper);
+        out_putc(pOut, pDigits[1]);
+        pState->cbSrc--;
+        pState->cPadBefore = 0;
+    }
+    size_t cbBytes = pState->cPadBefore ? 0 : MIN(pState->cbSrc, (size_t)(pOut->pEnd - pOut->pDest) / 2);
+    render_hexdump(pOut, pSrc, cbBytes, upper, false);
+    pSrc += cbBytes;
+    pState->cbSrc -= cbBytes;
+    if (pState->cbSrc && !pState->cPadBefore && pOut->pDest < pOut->pEnd) {  // the high digit of the next byte ends the chunk
+        hex_bytes(pDigits, pSrc, 1, upper);
+        out_putc(pOut, pDigits[0]);
+        pState->cPadBefore = 1;
+    }
+    pState->pSrc = (const char *)pSrc;
+    if (!pState->cbSrc) {
+        pState->cut = '\0';
+    }
+}
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+
+// starts the conversion of `pSpec` at `pPercent`, and leaves `pState->cut` set if the end of `pOut` cuts it
+// "%s" and "%H" are handed out from their source; the others are rendered into the scratch when they may not fit the rest
+// of the chunk, for the next chunks to copy their rest from there, and straight into the chunk otherwise
+static void start_conversion(pico_fmt_state *pState, pico_out *pOut, const pico_format_spec *pSpec, const char *pPercent) {
+    pico_format_spec resolved;
+    if ('s' == pSpec->format) {
+        pSpec = resolve_spec(pSpec, &resolved, &pState->vl);
+        pState->pSrc = va_arg(pState->vl, const char *);
+        pState->cbSrc = (size_t)string_layout(pSpec, pState->pSrc, &pState->cPadBefore, &pState->chPad, &pState->cPadAfter);
+        pState->cut = 's';
+        resume_span(pState, pOut);
+        return;
+    }
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+    if ('H' == pSpec->format) {
+        pSpec = resolve_spec(pSpec, &resolved, &pState->vl);
+        pState->pSrc = va_arg(pState->vl, const char *);
+        pState->cbSrc = (size_t)MAX(pSpec->whole_chars, 0);
+        pState->chPad = pSpec->flags.render_in_lowercase ? 'a' : 'A';
+        pState->cPadBefore = 0;
+        pState->cut = 'H';
+        resume_hexdump(pState, pOut);
+        return;
+    }
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+    va_copy(pState->vlCut, pState->vl);             // for a conversion longer than the scratch, rendered again by each chunk
+    size_t cbRoom = (size_t)(pOut->pEnd - pOut->pDest);
+    if (cbRoom >= PICOFORMAT_RESUME_SIZE) {
+        char *pStart = pOut->pDest;
+        render_spec(pOut, pSpec, &pState->vl);
+        if (pOut->cbCounted) {
+            pState->cut = 'r';
+            pState->pSrc = pPercent;
+            pState->cbSrc = (size_t)(pOut->pDest - pStart);
+            pOut->cbCounted = 0;
+            return;
+        }
+    } else {
+        pico_out scratch = { pState->pScratch, pState->pScratch + PICOFORMAT_RESUME_SIZE, pState->pScratch };
+        render_spec(&scratch, pSpec, &pState->vl);
+        size_t cbScratch = (size_t)(scratch.pDest - pState->pScratch);
+        if (scratch.cbCounted) {
+            out_write(pOut, pState->pScratch, cbRoom);  // a first part of it, as the rest of the chunk is shorter than the scratch
+            pState->cut = 'r';
+            pState->pSrc = pPercent;
+            pState->cbSrc = cbRoom;
+            return;
+        }
+        pState->pSrc = pState->pScratch;
+        pState->cbSrc = cbScratch;
+        pState->cPadBefore = pState->cPadAfter = 0;
+        pState->cut = 's';
+        resume_span(pState, pOut);
+    }
+    va_end(pState->vlCut);
+}
+
+
+void pico_fmt_begin(pico_fmt_state *pState, const char *pFormat, va_list vl) {
+    pState->pFormat = pFormat;
+    pState->cut = '\0';
+    pState->cbOutput = 0;
+    va_copy(pState->vl, vl);
+}
+
+
+// the interpreter of `format()`, but stopped by the end of the chunk: the literals are cut anywhere, and resumed from
+// where they were cut, and so are the conversions, from the state of their rest (see `start_conversion()`)
+size_t pico_fmt_next(pico_fmt_state *pState, char *pDest, size_t cbDest) {
+    if (!pState->pFormat) {
+        return 0;
+    }
+    pico_out out = { pDest, pDest + cbDest, pDest };   // no null-terminator: every char of the chunk is output
+    switch (pState->cut) {
+    case 's':
+        resume_span(pState, &out);
+        break;
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+    case 'H':
+        resume_hexdump(pState, &out);
+        break;
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+    case 'r':
+        resume_render(pState, &out);
+        break;
+    }
+    const char *pFormat = pState->pFormat;
+    while (!pState->cut && *pFormat && out.pDest < out.pEnd) {
+        if ('%' != *pFormat) {
+            pFormat = out_literal(&out, pFormat) - out.cbCounted;   // the chars past the chunk start the next one
+            out.cbCounted = 0;
+        } else if ('%' == pFormat[1]) {
+            out_putc(&out, '%');
+            pFormat += 2;
+        } else {
+            pico_format_spec spec;
+            const char *pNext = parse_spec(pFormat + 1, &spec);
+#ifdef PICOFORMAT_STATS
+            stats_count_conversion(thread_stats(), &spec, pNext);
+#endif // PICOFORMAT_STATS
+            start_conversion(pState, &out, &spec, pFormat);
+            pFormat = pNext;
+        }
+    }
+    pState->pFormat = pFormat;
+    pState->cbOutput += (size_t)(out.pDest - pDest);
+    if (!pState->cut && !*pFormat) {
+#ifdef PICOFORMAT_STATS
+        stats_count_call(pState->cbOutput, false);      // a single call, however many chunks it took
+#endif // PICOFORMAT_STATS
+        pico_fmt_end(pState);
+    }
+    return (size_t)(out.pDest - pDest);
+}
+
+
+void pico_fmt_end(pico_fmt_state *pState) {
+    if (pState->pFormat) {
+        if ('r' == pState->cut) {
+            va_end(pState->vlCut);
+        }
+        pState->cut = '\0';
+        va_end(pState->vl);
+        pState->pFormat = NULL;
+    }
+}
+
+
+const char *pico_format_next(const char *pFormat, pico_format_op *pOp) {
+    pOp->pLiteral = pFormat;
+    for (; *pFormat && '%' != *pFormat; pFormat++);
+    pOp->spec.format = '\0';
+    if ('%' == *pFormat && '%' == pFormat[1]) {   // "%%": keep the first '%' in the literal, skip the second
+        pFormat++;
+        pOp->cbLiteral = pFormat - pOp->pLiteral;
+        pFormat++;
+    } else {
+        pOp->cbLiteral = pFormat - pOp->pLiteral;
+        if ('%' == *pFormat) {
+            pFormat = parse_spec(pFormat + 1, &pOp->spec);
+        }
+    }
+    return pFormat;
+}
+
+
+int pico_format_compile(const char *pFormat, pico_compiled_fmt *pCompiled, pico_format_op *pOps, size_t cOps) {
+    size_t cUsed = 0;
+    while (*pFormat) {
+        if (cUsed == cOps) {
+            return -1;                      // the caller-provided storage is too small
+        }
+        pFormat = pico_format_next(pFormat, &pOps[cUsed++]);
+    }
+    pCompiled->pOps = pOps;
+    pCompiled->cOps = cUsed;
+    return (int)cUsed;
+}
+
+
+int pico_format_vrender(const pico_compiled_fmt *pCompiled, char *pDest, size_t cbDest, va_list vl) {
+    pico_out out = { pDest, cbDest ? pDest + cbDest - 1 : pDest, pDest };
+    va_list vlCopy;
+    va_copy(vlCopy, vl);
+    for (const pico_format_op *pOp = pCompiled->pOps, *pOpsEnd = pOp + pCompiled->cOps; pOp < pOpsEnd; pOp++) {
+        out_write(&out, pOp->pLiteral, pOp->cbLiteral);
+        if ('\0' != pOp->spec.format) {
+            render_spec(&out, &pOp->spec, &vlCopy);
+        }
+    }
+    va_end(vlCopy);
+    if (cbDest) {
+        *out.pDest = '\0';
+    }
+    return (int)OUT_TOTAL(&out);
+}
+
+
+int pico_format_render(const pico_compiled_fmt *pCompiled, char *pDest, size_t cbDest, ...) {
+    va_list vl;
+    va_start(vl, cbDest);
+    int result = pico_format_vrender(pCompiled, pDest, cbDest, vl);
+    va_end(vl);
+    return result;
 }
 
 
@@ -340,3 +2181,277 @@ int pico_snprintf(char *pDest, size_t cbDest, const char *pFormat, ...) {
     va_end(vl);
     return result;
 }
+
+
+#ifdef PICOFORMAT_STATS
+int pico_stats_snapshot(pico_stats *pStats) {
+    pico_stats empty = {0};
+    *pStats = empty;
+    int cThreads = (int)MIN(g_cStatsThreads, PICOFORMAT_STATS_THREADS);
+    for (const pico_stats *pSlot = g_pStatsSlots; pSlot < g_pStatsSlots + cThreads; pSlot++) {
+        pStats->calls += STATS_LOAD(pSlot, calls);
+        pStats->bytes += STATS_LOAD(pSlot, bytes);
+        pStats->truncations += STATS_LOAD(pSlot, truncations);
+        pStats->parse_ticks += STATS_LOAD(pSlot, parse_ticks);
+        pStats->render_ticks += STATS_LOAD(pSlot, render_ticks);
+        for (int ii = 0; ii < PICO_STATS_CONVERSIONS; ii++) {
+            pStats->conversions[ii] += STATS_LOAD(pSlot, conversions[ii]);
+        }
+        for (int ii = 0; ii < PICO_STATS_LENGTHS; ii++) {
+            pStats->lengths[ii] += STATS_LOAD(pSlot, lengths[ii]);
+        }
+    }
+    return cThreads;
+}
+
+
+void pico_stats_reset(void) {
+    pico_stats empty = {0};
+    for (int ii = 0; ii < PICOFORMAT_STATS_THREADS; ii++) {
+        g_pStatsSlots[ii] = empty;
+    }
+}
+
+
+// e.g. "12 calls (1 truncated), 345 bytes, ticks: 678 parsing, 901 rendering\n  %d: 20 %s: 4\n  [16, 32): 11 [32, 64): 1\n"
+int pico_stats_dump(pico_flush_fn flush, void *pCtx) {
+    pico_stats stats;
+    pico_stats_snapshot(&stats);            // first: the dump itself is counted, too
+    int len = pico_fctprintf(flush, pCtx, "%llu calls (%llu truncated), %llu bytes, ticks: %llu parsing, %llu rendering\n ",
+        (unsigned long long)stats.calls, (unsigned long long)stats.truncations, (unsigned long long)stats.bytes,
+        (unsigned long long)stats.parse_ticks, (unsigned long long)stats.render_ticks);
+    for (int ii = 0; ii < PICO_STATS_CONVERSIONS; ii++) {
+        if (stats.conversions[ii]) {
+            len += pico_fctprintf(flush, pCtx, " %%%c: %llu", 'A' + ii, (unsigned long long)stats.conversions[ii]);
+        }
+    }
+    len += pico_fctprintf(flush, pCtx, "\n ");
+    for (int ii = 0; ii < PICO_STATS_LENGTHS; ii++) {
+        if (stats.lengths[ii]) {
+            len += ii < PICO_STATS_LENGTHS - 1
+                ? pico_fctprintf(flush, pCtx, " [%d, %d): %llu", ii ? 8 << ii : 0, 16 << ii, (unsigned long long)stats.lengths[ii])
+                : pico_fctprintf(flush, pCtx, " [%d, inf): %llu", 8 << ii, (unsigned long long)stats.lengths[ii]);
+        }
+    }
+    return len + pico_fctprintf(flush, pCtx, "\n");
+}
+#endif // PICOFORMAT_STATS
+
+
+#ifdef PICOPRINTF_IMPLEMENTATION
+// the constant formats of the single-header mode (see the bottom of picoprintf.h): the spec is known ahead, so nothing is parsed,
+// and once `render_spec()` is inlined, the branch of that conversion is all that is left of its `switch`
+static inline int render_single(char *pDest, size_t cbDest, const pico_format_spec *pSpec, char conversion, va_list *pvl) {
+    pico_out out = { pDest, cbDest ? pDest + cbDest - 1 : pDest, pDest };
+    render_spec(&out, pSpec, pvl);
+    if (cbDest) {
+        *out.pDest = '\0';
+    }
+#ifdef PICOFORMAT_STATS
+    thread_stats()->conversions[conversion - 'A']++;    // no parsing, and too short to time
+    stats_count_call(OUT_TOTAL(&out), cbDest && OUT_TOTAL(&out) >= cbDest);
+#else  // PICOFORMAT_STATS
+    (void)conversion;
+#endif // PICOFORMAT_STATS
+    return (int)OUT_TOTAL(&out);
+}
+
+// defines `pico_snprintf_<name>()`, which renders its only argument as `pico_snprintf()` does with the format that `setup` describes
+#define CONSTANT_FORMAT(name, setup) \
+    static inline int pico_snprintf_##name(char *pDest, size_t cbDest, ...) { \
+        pico_format_spec spec = {0}; \
+        spec.decimal_chars = -1; \
+        setup; \
+        va_list vl; \
+        va_start(vl, cbDest); \
+        int result = render_single(pDest, cbDest, &spec, #name[sizeof(#name) - 2], &vl); \
+        va_end(vl); \
+        return result; \
+    }
+
+CONSTANT_FORMAT(d, spec.format = 'd')
+CONSTANT_FORMAT(u, spec.format = 'd'; spec.flags.treat_as_unsigned = 1)
+CONSTANT_FORMAT(s, spec.format = 's')
+#ifdef PICOFORMAT_HANDLE_HEX
+CONSTANT_FORMAT(x, spec.format = 'b'; spec.bits_per_digit = 4; spec.flags.treat_as_unsigned = spec.flags.render_in_lowercase = 1)
+#ifdef PICOFORMAT_HANDLE_FILL
+CONSTANT_FORMAT(08x, spec.format = 'b'; spec.bits_per_digit = 4; spec.flags.treat_as_unsigned = spec.flags.render_in_lowercase = 1;
+                spec.whole_chars = 8; spec.flags.fill_zeros = spec.flags.seen_numbers = 1)
+#endif // PICOFORMAT_HANDLE_FILL
+#endif // PICOFORMAT_HANDLE_HEX
+#endif // PICOPRINTF_IMPLEMENTATION
+
+
+void pico_binit(pico_buf *pBuf, char *pDest, size_t cbDest) {
+    pBuf->pBase = pDest;
+    pBuf->cbCapacity = cbDest;
+    pBuf->cbUsed = 0;
+    pBuf->truncated = 0;
+    if (cbDest) {
+        *pDest = '\0';
+    }
+}
+
+
+int pico_vbprintf(pico_buf *pBuf, const char *pFormat, va_list vl) {
+    size_t cbRoom = pBuf->cbCapacity - pBuf->cbUsed;        // never 0 once there is a buffer: the null-terminator always fits
+    int len = pico_vsnprintf(pBuf->cbCapacity ? pBuf->pBase + pBuf->cbUsed : NULL, cbRoom, pFormat, vl);
+    if ((size_t)len < cbRoom) {
+        pBuf->cbUsed += len;
+    } else if (len) {                                       // what fits is kept, up to the null-terminator
+        pBuf->cbUsed += cbRoom ? cbRoom - 1 : 0;
+        pBuf->truncated = 1;
+    }
+    return len;
+}
+
+
+int pico_bprintf(pico_buf *pBuf, const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    int result = pico_vbprintf(pBuf, pFormat, vl);
+    va_end(vl);
+    return result;
+}
+
+
+void pico_bputs(pico_buf *pBuf, const char *pStr) {
+    if (pBuf->cbCapacity) {
+        char *pDest = pBuf->pBase + pBuf->cbUsed;
+        char *pLast = pBuf->pBase + pBuf->cbCapacity - 1;  // room for the null-terminator
+        for (; *pStr && pDest < pLast; *pDest++ = *pStr++);
+        *pDest = '\0';
+        pBuf->cbUsed = pDest - pBuf->pBase;
+    }
+    pBuf->truncated |= '\0' != *pStr;
+}
+
+
+void pico_bputc(pico_buf *pBuf, char ch) {
+    if (pBuf->cbUsed + 1 < pBuf->cbCapacity) {
+        pBuf->pBase[pBuf->cbUsed++] = ch;
+        pBuf->pBase[pBuf->cbUsed] = '\0';
+    } else {
+        pBuf->truncated = 1;
+    }
+}
+
+
+pico_bmark pico_bmark_get(const pico_buf *pBuf) {
+    pico_bmark mark = { pBuf->cbUsed, pBuf->truncated };
+    return mark;
+}
+
+
+void pico_brollback(pico_buf *pBuf, pico_bmark mark) {
+    pBuf->cbUsed = mark.cbUsed;
+    pBuf->truncated = mark.truncated;
+    if (pBuf->cbCapacity) {
+        pBuf->pBase[mark.cbUsed] = '\0';
+    }
+}
+
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+int pico_hexdump(char *pDest, size_t cbDest, const void *pData, size_t cbData, unsigned flags) {
+    pico_out out = { pDest, cbDest ? pDest + cbDest - 1 : pDest, pDest };
+    render_hexdump(&out, (const unsigned char *)pData, cbData, flags & PICO_HEXDUMP_UPPERCASE, flags & PICO_HEXDUMP_SPACED);
+    if (cbDest) {
+        *out.pDest = '\0';
+    }
+    return (int)OUT_TOTAL(&out);
+}
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+
+#ifdef PICOFORMAT_HANDLE_ARRAYS
+// appends a value rendered into [pDigits, pDigits + cDigits), with its sign and padding, and the separator before it
+// returns false, appending nothing, if it does not fit in full
+static bool array_append(char **ppDest, const char *pEnd, const char *pDigits, int cDigits, bool negative, char separator, unsigned flags) {
+    char *pDest = *ppDest;
+    int width = (int)(flags & 0xff);
+    int cPadding = MAX(width - cDigits - negative, 0);
+    if (pEnd - pDest < (separator ? 1 : 0) + negative + cDigits + cPadding) {
+        return false;
+    }
+    if (separator) {
+        *pDest++ = separator;
+    }
+    if (!(flags & (PICO_ARRAY_FILL_ZEROS | PICO_ARRAY_LEFT_ALIGN))) {
+        for (int ii = 0; ii < cPadding; ii++) {
+            *pDest++ = ' ';
+        }
+    }
+    if (negative) {
+        *pDest++ = '-';
+    }
+    if (flags & PICO_ARRAY_FILL_ZEROS && !(flags & PICO_ARRAY_LEFT_ALIGN)) {
+        for (int ii = 0; ii < cPadding; ii++) {
+            *pDest++ = '0';
+        }
+    }
+    for (int ii = 0; ii < cDigits; ii++) {
+        pDest[ii] = pDigits[ii];
+    }
+    pDest += cDigits;
+    if (flags & PICO_ARRAY_LEFT_ALIGN) {
+        for (int ii = 0; ii < cPadding; ii++) {
+            *pDest++ = ' ';
+        }
+    }
+    *ppDest = pDest;
+    return true;
+}
+
+
+size_t pico_format_i32_array(char *pDest, size_t cbDest, const int32_t *pValues, size_t cValues, char separator, unsigned flags) {
+    if (0 == cbDest) {
+        return 0;
+    }
+    char *pEnd = pDest + cbDest - 1;                // the room for the null-terminator
+    size_t ii = 0;
+    for (; ii < cValues; ii++) {
+        int32_t val = pValues[ii];
+        uint32_t magnitude = val < 0 ? 0u - (uint32_t)val : (uint32_t)val;
+        if (0 == (flags & 0xff) && pEnd - pDest >= 18) {    // no padding, and the room for the 8-digit stores: straight in place
+            *pDest = separator;
+            pDest += ii && separator;
+            *pDest = '-';
+            pDest += val < 0;
+            pDest += array_u32_digits(pDest, magnitude);
+            continue;
+        }
+        char pDigits[16];
+        int cDigits = array_u32_digits(pDigits, magnitude);
+        if (!array_append(&pDest, pEnd, pDigits, cDigits, val < 0, ii ? separator : '\0', flags)) {
+            break;
+        }
+    }
+    *pDest = '\0';
+    return ii;
+}
+
+
+size_t pico_format_u64_array(char *pDest, size_t cbDest, const uint64_t *pValues, size_t cValues, char separator, unsigned flags) {
+    if (0 == cbDest) {
+        return 0;
+    }
+    char *pEnd = pDest + cbDest - 1;
+    size_t ii = 0;
+    for (; ii < cValues; ii++) {
+        if (0 == (flags & 0xff) && pEnd - pDest >= 29) {
+            *pDest = separator;
+            pDest += ii && separator;
+            pDest += array_u64_digits(pDest, pValues[ii]);
+            continue;
+        }
+        char pDigits[28];
+        int cDigits = array_u64_digits(pDigits, pValues[ii]);
+        if (!array_append(&pDest, pEnd, pDigits, cDigits, false, ii ? separator : '\0', flags)) {
+            break;
+        }
+    }
+    *pDest = '\0';
+    return ii;
+}
+#endif // PICOFORMAT_HANDLE_ARRAYS
@@ -3,20 +3,258 @@
 
 #include <stddef.h>  // size_t
 #include <stdarg.h>  // va_*
+#include <stdint.h>  // int32_t, uint64_t
 
+// single-header mode: `#define PICOPRINTF_IMPLEMENTATION` before including this header (and do not build picoprintf.c), for the
+// implementation to be compiled into that translation unit as `static inline`, free to be inlined and pruned, e.g. with LTO
+// then `pico_snprintf()` with one of the literal formats "%d", "%u", "%s", "%x" and "%08x" skips the parsing (see the bottom)
+// (the functions of the features left out are not even declared there, for no `static` function to be left undefined)
+#ifdef PICOPRINTF_IMPLEMENTATION
+    #define PICOPRINTF_API static inline
+#else  // PICOPRINTF_IMPLEMENTATION
+    #define PICOPRINTF_API
+#endif // PICOPRINTF_IMPLEMENTATION
 
-int pico_snprintf(char *pDest, size_t cbDest, const char *pFormat, ...);
-int pico_vsnprintf(char *pDest, size_t cbDest, const char *pFormat, va_list vl);
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// return the length of the whole output (not counting the null-terminator) even if it was truncated to fit `cbDest`
+PICOPRINTF_API int pico_snprintf(char *pDest, size_t cbDest, const char *pFormat, ...);
+PICOPRINTF_API int pico_vsnprintf(char *pDest, size_t cbDest, const char *pFormat, va_list vl);
+
+// the measure mode: same as `pico_snprintf(NULL, 0, ...)`, counts the output without storing it, e.g. to allocate the exact size
+PICOPRINTF_API int pico_measure(const char *pFormat, ...);
+PICOPRINTF_API int pico_vmeasure(const char *pFormat, va_list vl);
+
+// streaming output: renders into a small chunk on the stack, and hands it over to `flush` every time it fills up
+// the span passed to `flush` stays untouched until the next call to `flush` returns, so it can be transmitted asynchronously
+// returns the total number of chars passed to `flush`
+typedef void (*pico_flush_fn)(void *pCtx, const char *pSrc, size_t cbSrc);
+PICOPRINTF_API int pico_fctprintf(pico_flush_fn flush, void *pCtx, const char *pFormat, ...);
+PICOPRINTF_API int pico_vfctprintf(pico_flush_fn flush, void *pCtx, const char *pFormat, va_list vl);
+
+// a resumable rendering, pulled a chunk at a time, e.g. straight into the fixed-size buffers of a DMA-driven UART: no staging
+// buffer of the whole output, and a stack footprint bounded by `PICOFORMAT_CHUNK_SIZE`; the arguments of `vl` must stay valid
+// until the end, i.e. the function that called `va_start()` may not return before that
+// a conversion cut by the end of a chunk resumes where it was cut: "%s" and "%H" from their source, and the others from the
+// scratch they were rendered into, unless longer than it (e.g. "%500d"), when they are rendered again by each chunk
+#ifndef PICOFORMAT_RESUME_SIZE
+    #define PICOFORMAT_RESUME_SIZE 80
+#endif // PICOFORMAT_RESUME_SIZE
+typedef struct {
+    const char *pFormat;            // the next literal or conversion; NULL once done
+    va_list vl;                     // the arguments from `pFormat` on
+    char cut;                       // how the conversion cut by the previous chunk resumes: 's', 'H', 'r' (below), or '\0' if none
+    char chPad;                     // 's': the padding before the span; 'H': 'A' or 'a', the case of the digits
+    int cPadBefore;                 // 's': the pad chars left before the span; 'H': 1 if the first byte has its low digit left
+    int cPadAfter;                  // 's': the spaces left after the span
+    const char *pSrc;               // 's': the chars of the span left (of the string, or of `pScratch`); 'H': the bytes left;
+                                    // 'r': the '%' of the conversion, rendered again from `vlCut`
+    size_t cbSrc;                   // 's', 'H': the chars or bytes left at `pSrc`; 'r': the chars handed out so far
+    va_list vlCut;                  // 'r': the arguments of the conversion
+    char pScratch[PICOFORMAT_RESUME_SIZE];
+    size_t cbOutput;                // the chars output so far
+} pico_fmt_state;
+// starts the output; its length is not measured up front: `pico_vmeasure()` tells it, if needed, at the cost of a rendering
+PICOPRINTF_API void pico_fmt_begin(pico_fmt_state *pState, const char *pFormat, va_list vl);
+// fills `pDest` with the next `cbDest` chars of the output (fewer only in the last chunk, even none), without a null-terminator; returns
+// their number; once the output is done, `pState->pFormat` is NULL and the state is released by itself
+PICOPRINTF_API size_t pico_fmt_next(pico_fmt_state *pState, char *pDest, size_t cbDest);
+// releases the copies of the `va_list` of an output abandoned before its end (a no-op once done)
+PICOPRINTF_API void pico_fmt_end(pico_fmt_state *pState);
+
+// an append cursor over the caller's buffer, e.g. on the stack, for assembling a message out of several pieces in O(1) each:
+// no `buf + len, sizeof(buf) - len` by hand, and no `strlen()` before each append; the buffer stays null-terminated throughout
+// an append that does not fit keeps what fits, as `pico_snprintf()` does, and sets `truncated`, which sticks until a rollback
+typedef struct {
+    char *pBase;
+    size_t cbCapacity;                  // the null-terminator included
+    size_t cbUsed;                      // the chars appended so far, not counting the null-terminator at `pBase[cbUsed]`
+    int truncated;
+} pico_buf;
+
+// the state of a `pico_buf` to roll back to, e.g. for dropping a field that did not fit whole, or a speculative branch of a record
+// marks nest: rolling back to a mark drops everything appended after it, the later marks included
+typedef struct {
+    size_t cbUsed;
+    int truncated;
+} pico_bmark;
+
+PICOPRINTF_API void pico_binit(pico_buf *pBuf, char *pDest, size_t cbDest);
+// return the length of the whole append, as `pico_snprintf()` does, even if it was truncated
+PICOPRINTF_API int pico_bprintf(pico_buf *pBuf, const char *pFormat, ...);
+PICOPRINTF_API int pico_vbprintf(pico_buf *pBuf, const char *pFormat, va_list vl);
+PICOPRINTF_API void pico_bputs(pico_buf *pBuf, const char *pStr);
+PICOPRINTF_API void pico_bputc(pico_buf *pBuf, char ch);
+PICOPRINTF_API pico_bmark pico_bmark_get(const pico_buf *pBuf);
+PICOPRINTF_API void pico_brollback(pico_buf *pBuf, pico_bmark mark);
+
+// bulk hex dump (requires `PICOFORMAT_HANDLE_HEXDUMP`): two hex digits per byte of `pData`, e.g. "deadbeef"
+// same output as "%*H" (but lowercase, unless `PICO_HEXDUMP_UPPERCASE`), and the same return value as `pico_snprintf()`
+#define PICO_HEXDUMP_UPPERCASE 1        // "DEADBEEF"
+#define PICO_HEXDUMP_SPACED    2        // "de ad be ef"
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+PICOPRINTF_API int pico_hexdump(char *pDest, size_t cbDest, const void *pData, size_t cbData, unsigned flags);
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+
+// bulk integer arrays (requires `PICOFORMAT_HANDLE_ARRAYS`): all the values in decimal, `separator` between them (unless '\0'),
+// e.g. "1,-2,3", padded to the width in the low byte of `flags`; same output as a "%d" (or "%llu") per value, without the parsing
+// only whole values are written: returns how many fit, and the output is null-terminated right after the last of them
+#define PICO_ARRAY_WIDTH(__width) ((unsigned)(__width) & 0xff)  // "%6d"
+#define PICO_ARRAY_FILL_ZEROS   0x100   // "%06d"
+#define PICO_ARRAY_LEFT_ALIGN   0x200   // "%-6d"
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_ARRAYS)
+PICOPRINTF_API size_t pico_format_i32_array(char *pDest, size_t cbDest, const int32_t *pValues, size_t cValues, char separator, unsigned flags);
+PICOPRINTF_API size_t pico_format_u64_array(char *pDest, size_t cbDest, const uint64_t *pValues, size_t cValues, char separator, unsigned flags);
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_ARRAYS)
+
+// hot-path statistics (requires `PICOFORMAT_STATS`): what the interpreted formats cost, i.e. `pico_vsnprintf()` and all
+// that is built on it, `pico_snprintf()`, `pico_measure()` and `pico_fctprintf()` included; without the macro, nothing is compiled in
+// each thread counts into a slot of its own, so the formatting threads never contend; the ticks come from `PICOFORMAT_STATS_CLOCK()`
+#define PICO_STATS_CONVERSIONS ('z' - 'A' + 1)  // per conversion char as written, e.g. `conversions['x' - 'A']` for "%08x"
+#define PICO_STATS_LENGTHS 8    // the output lengths, in powers of 2: [0, 16), [16, 32), [32, 64), ..., [1024, inf)
+typedef struct {
+    uint64_t calls;
+    uint64_t bytes;                             // the length of the whole output of every call, before any truncation
+    uint64_t truncations;                       // the calls whose output did not fit `cbDest` (the measure mode never truncates)
+    uint64_t parse_ticks;                       // parsing the formats, and copying their literal text
+    uint64_t render_ticks;                      // rendering the conversions
+    uint64_t conversions[PICO_STATS_CONVERSIONS];
+    uint64_t lengths[PICO_STATS_LENGTHS];       // the calls per output length
+} pico_stats;
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_STATS)
+// sums the counters of all the threads into `pStats` (approximate while they are formatting), and returns the number of threads
+PICOPRINTF_API int pico_stats_snapshot(pico_stats *pStats);
+// zeroes the counters of all the threads (the counts of the threads formatting meanwhile may survive it)
+PICOPRINTF_API void pico_stats_reset(void);
+// renders `pico_stats_snapshot()` as text, through `flush` as `pico_fctprintf()` does; returns the number of chars
+PICOPRINTF_API int pico_stats_dump(pico_flush_fn flush, void *pCtx);
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_STATS)
+
+
+#ifdef __aarch64__                      // these platforms benefit from packing flags into bit fields
+    #define PICOFORMAT_FLAG(__name) unsigned __name:1
+#else                                   // other platforms do not benefit from bit packing
+    #define PICOFORMAT_FLAG(__name) unsigned char __name
+#endif                                  // bit packing platforms
+
+// a parsed conversion specification, e.g. "%-08.3lx"
+typedef struct {
+    char format;                        // conversion: 'c', 's', 'd'/'i', 'b' (binary, octal, and hex), floats ('f', 'e', 'g', 'r', and uppercase), 'Q', 'H', 'T', custom; '\0' if none
+    signed char bits_per_digit;         // valid in 'b' mode only: 1, 3, or 4
+    signed char fraction_bits;          // valid in 'Q' mode only: 0..60
+    int whole_chars;                    // width
+    int decimal_chars;                  // precision, -1 if not specified
+    struct {
+        PICOFORMAT_FLAG(force_sign);
+        PICOFORMAT_FLAG(fill_zeros);
+        PICOFORMAT_FLAG(left_align);
+        PICOFORMAT_FLAG(seen_period);
+        PICOFORMAT_FLAG(seen_numbers);
+        PICOFORMAT_FLAG(treat_as_unsigned);
+        PICOFORMAT_FLAG(treat_as_long);
+        PICOFORMAT_FLAG(render_in_lowercase);
+        PICOFORMAT_FLAG(whole_from_arg);    // width is '*'
+        PICOFORMAT_FLAG(decimal_from_arg);  // precision is '*'
+    } flags;
+} pico_format_spec;
+
+// one step of a compiled format: a literal span followed by an (optional) conversion
+typedef struct {
+    const char *pLiteral;               // points into the original format string, which must outlive the compiled format
+    size_t cbLiteral;
+    pico_format_spec spec;              // `spec.format` is '\0' when the op is a literal only
+} pico_format_op;
+
+typedef struct {
+    const pico_format_op *pOps;
+    size_t cOps;
+} pico_compiled_fmt;
+
+// parses `pFormat` once into `pOps` (caller-provided storage for `cOps` ops, one per conversion plus one per trailing literal or "%%")
+// returns the number of ops used, or -1 if `cOps` is too small
+PICOPRINTF_API int pico_format_compile(const char *pFormat, pico_compiled_fmt *pCompiled, pico_format_op *pOps, size_t cOps);
+// parses a single op of `pFormat` into `pOp`, e.g. for walking a format without storing all its ops
+// returns the pointer past the op: the format is done when it points to the null-terminator
+PICOPRINTF_API const char *pico_format_next(const char *pFormat, pico_format_op *pOp);
+// same output as `pico_snprintf()` with the original format string, but without parsing it again
+PICOPRINTF_API int pico_format_render(const pico_compiled_fmt *pCompiled, char *pDest, size_t cbDest, ...);
+PICOPRINTF_API int pico_format_vrender(const pico_compiled_fmt *pCompiled, char *pDest, size_t cbDest, va_list vl);
+
+// the destination of the rendering: either the caller's buffer (truncated at `pEnd`), or a chunk drained by `flush`
+// a NULL buffer is the measure mode: nothing is stored, and the conversions may skip rendering their digits
+typedef struct {
+    char *pDest;                    // the next char goes here
+    char *pEnd;                     // end of the writable span (the buffer mode keeps one more char for the null-terminator)
+    char *pChunk;                   // start of the buffer, or of the half-chunk being filled in the sink mode
+    pico_flush_fn flush;            // NULL in the buffer mode
+    void *pCtx;
+    char *pSpare;                   // sink mode only: start of the other half-chunk, possibly still being transmitted
+    size_t cbCounted;               // chars that are not in [pChunk, pDest): handed over to `flush`, or dropped for lack of space
+} pico_out;
+
+// the conversion kernels behind all the entry points, one per kind of conversion, e.g. for picoprintf.hpp to call them
+// directly from formats parsed at compile time; the '*' width and precision in `pSpec` must already be resolved
+PICOPRINTF_API void pico_emit_literal(pico_out *pOut, const char *pSrc, size_t cbSrc);
+PICOPRINTF_API void pico_emit_char(pico_out *pOut, const pico_format_spec *pSpec, int ch);
+PICOPRINTF_API void pico_emit_string(pico_out *pOut, const pico_format_spec *pSpec, const char *pStr);
+PICOPRINTF_API void pico_emit_decimal(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val);  // `val` is sign-extended when signed
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
+PICOPRINTF_API void pico_emit_radix(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val);    // 'b', 'o', 'x' (requires one of them)
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEX) || defined(PICOFORMAT_HANDLE_OCT) || defined(PICOFORMAT_HANDLE_BIN)
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_FLOATS)
+PICOPRINTF_API void pico_emit_double(pico_out *pOut, const pico_format_spec *pSpec, double val);               // requires `PICOFORMAT_HANDLE_FLOATS`
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_FLOATS)
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_FIXEDPOINT)
+PICOPRINTF_API void pico_emit_fixed(pico_out *pOut, const pico_format_spec *pSpec, unsigned long long val);    // requires `PICOFORMAT_HANDLE_FIXEDPOINT`
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_FIXEDPOINT)
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+PICOPRINTF_API void pico_emit_hexdump(pico_out *pOut, const pico_format_spec *pSpec, const void *pData);        // requires `PICOFORMAT_HANDLE_HEXDUMP`
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEXDUMP)
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_TIMESTAMP)
+PICOPRINTF_API void pico_emit_timestamp(pico_out *pOut, const pico_format_spec *pSpec, long long ns);           // requires `PICOFORMAT_HANDLE_TIMESTAMP`
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_TIMESTAMP)
+
+// the typed kernels, `to_chars()`-style: no format, no `va_list`, no null-terminator; each renders into [pDest, pEnd) and
+// returns the end of what it wrote, or NULL if that does not fit (the contents of [pDest, pEnd) are then unspecified)
+PICOPRINTF_API char *pico_u32toa(char *pDest, char *pEnd, uint32_t val);                                       // "%u"
+PICOPRINTF_API char *pico_u64toa(char *pDest, char *pEnd, uint64_t val);                                       // "%lu"
+PICOPRINTF_API char *pico_i64toa(char *pDest, char *pEnd, int64_t val);                                        // "%ld"
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEX)
+PICOPRINTF_API char *pico_xtoa(char *pDest, char *pEnd, uint64_t val, int width, int upper);                   // "%0*lx", requires `PICOFORMAT_HANDLE_HEX`
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_HEX)
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_FLOATS)
+PICOPRINTF_API char *pico_ftoa(char *pDest, char *pEnd, double val, int precision);                            // "%.*f", requires `PICOFORMAT_HANDLE_FLOATS`
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_FLOATS)
+PICOPRINTF_API char *pico_strpad(char *pDest, char *pEnd, const char *pStr, int width);                        // "%*s": negative `width` aligns left
+
+// custom conversions (requires `PICOFORMAT_HANDLE_CUSTOM`), e.g. "%I" of an IPv4 address or "%M" of a MAC address, rendered in
+// place rather than into a temporary buffer passed to "%s": the handler reads its argument(s) from `pvl` and renders them into
+// `pOut` with the kernels above, all of the flags, the width and the precision of the conversion in `pSpec` ('*' resolved)
+typedef void (*pico_conversion_fn)(pico_out *pOut, const pico_format_spec *pSpec, va_list *pvl);
+#define PICO_CONVERSIONS ('z' - 'A' + 1)
+#if !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_CUSTOM)
+// registers `handler` for the letter `ch`, or unregisters it with NULL; returns -1 if `ch` is not a letter, or is one of the
+// conversions or length modifiers of C99 or picoprintf (whether or not enabled); not thread-safe: meant for the startup
+PICOPRINTF_API int pico_register_conversion(char ch, pico_conversion_fn handler);
+#endif // !defined(PICOPRINTF_IMPLEMENTATION) || defined(PICOFORMAT_HANDLE_CUSTOM)
 
 // PLEASE use `pico_snprintf()` instead!!!  This function is vulnerable to buffer overflows
-inline int pico_sprintf(char *pDest, const char *pFormat, ...) {
+static inline int pico_sprintf(char *pDest, const char *pFormat, ...) {
     va_list vl;
     va_start(vl, pFormat);
-    int result = pico_vsnprintf(pDest, -1, pFormat, vl);
+    // up to the end of the address space (-1 would wrap around), and no further than a pointer difference reaches
+    uintptr_t cbRoom = ~(uintptr_t)pDest < (uintptr_t)PTRDIFF_MAX ? ~(uintptr_t)pDest : (uintptr_t)PTRDIFF_MAX;
+    int result = pico_vsnprintf(pDest, (size_t)cbRoom, pFormat, vl);
     va_end(vl);
     return result;
 }
 
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
 
 //
 // IMPORTANT!!!
@@ -27,10 +265,44 @@ inline int pico_sprintf(char *pDest, const char *pFormat, ...) {
 // #define PICOFORMAT_HANDLE_BIN           // uncomment this line to handle "%b" -- binary representation
 // #define PICOFORMAT_HANDLE_OCT           // uncomment this line to handle "%o"
 // #define PICOFORMAT_HANDLE_HEX           // uncomment this line to handle "%x" and "%X"
-// #define PICOFORMAT_HANDLE_FLOATS        // uncomment this line to handle the "%f"
+// #define PICOFORMAT_HANDLE_HEXDUMP       // uncomment this line to handle "%*H" (a hex dump of the pointed-to bytes) and `pico_hexdump()`
+// #define PICOFORMAT_HANDLE_ARRAYS       // uncomment this line to enable `pico_format_i32_array()` and `pico_format_u64_array()`
+// #define PICOFORMAT_HANDLE_FLOATS        // uncomment this line to handle the "%f" -- exact, integer-only: no libm needed
+// #define PICOFORMAT_HANDLE_EXPONENTS     // uncomment this line (with the one above) to handle "%e", "%g", and the non-standard shortest round-trip "%r"
+// #define PICOFORMAT_HANDLE_FIXEDPOINT    // uncomment this line to handle "%Q16" and "%.3lQ31" -- fixed point with that many fractional bits, integer-only (no floats)
+// #define PICOFORMAT_HANDLE_TIMESTAMP     // uncomment this line to handle "%T" (a `struct timespec *`, of C11 or POSIX) and "%.3lT" (nanoseconds) -- RFC 3339 timestamps in UTC, no libc time functions
+// #define PICOFORMAT_HANDLE_CUSTOM        // uncomment this line to handle the conversions registered with `pico_register_conversion()`, e.g. "%I"
+// #define PICOFORMAT_FAST_DECIMAL         // uncomment this line to render "%d"/"%i"/"%u" two digits per division (+200 bytes table, native 32-bit path without 'l')
+// #define PICOFORMAT_FAST_COPY            // uncomment this line to copy long literals, "%s" and padding with memcpy()/memset() (needs <string.h>, reads the format 8 bytes at a time)
+// #define PICOFORMAT_STATS                // uncomment this line to count the calls, conversions, truncations, output lengths and ticks of the formatting, per thread (see `pico_stats`)
 // #define PICOFORMAT_CLANG_QUIRK          // uncomment this line to match clang's non-standard "%010s" behavior (zero-pad strings when both '0' flag and width are set)
 
 
+// the chunk of `pico_fctprintf()` consists of two halves of this size, so its stack footprint is twice as big
+#ifndef PICOFORMAT_CHUNK_SIZE
+    #define PICOFORMAT_CHUNK_SIZE 32
+#endif // PICOFORMAT_CHUNK_SIZE
+
+
+// `PICOFORMAT_STATS` counts into this many slots: one per thread, up to the last one, which the threads past it share (with
+// atomic additions); a thread keeps its slot until the process exits; 1 does without thread-local storage
+#ifndef PICOFORMAT_STATS_THREADS
+    #define PICOFORMAT_STATS_THREADS 16
+#endif // PICOFORMAT_STATS_THREADS
+
+// `PICOFORMAT_STATS` reads this clock: the TSC on x86, the virtual counter on ARM64, and elsewhere nothing, unless defined
+// to a free-running counter of the target (e.g. the DWT cycle counter of a Cortex-M)
+#ifndef PICOFORMAT_STATS_CLOCK
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        #define PICOFORMAT_STATS_CLOCK() __builtin_ia32_rdtsc()
+    #elif defined(__GNUC__) && defined(__aarch64__)
+        #define PICOFORMAT_STATS_CLOCK() ({ uint64_t __ticks; __asm__ volatile("mrs %0, cntvct_el0" : "=r"(__ticks)); __ticks; })
+    #else  // clock
+        #define PICOFORMAT_STATS_CLOCK() 0
+    #endif // clock
+#endif // PICOFORMAT_STATS_CLOCK
+
+
 // by default, the debug builds (determined by `#define _DEBUG`) will real-time print errors when a feature is used that is not enabled above
 #ifndef FORMAT_ERROR_DELEGATE
     #ifdef _DEBUG
@@ -40,4 +312,37 @@ inline int pico_sprintf(char *pDest, const char *pFormat, ...) {
     #endif // _DEBUG
 #endif // FORMAT_ERROR_DELEGATE
 
+
+#ifdef PICOPRINTF_IMPLEMENTATION
+#include "picoprintf.c"
+
+#if defined(__GNUC__)                   // gcc and clang: a literal format is compared at compile time, and only its branch is left
+// true when `pFormat` is known at compile time to be `pLiteral`: never true at -O0, nor for a format known at run time only
+#define PICO_FORMAT_IS(pFormat, pLiteral) (__builtin_constant_p((pFormat)[0]) && 0 == __builtin_strcmp((pFormat), (pLiteral)))
+
+#if defined(PICOFORMAT_HANDLE_HEX) && defined(PICOFORMAT_HANDLE_FILL)
+    #define PICO_FORMAT_DISPATCH_08X(pDest, cbDest, pFormat, ...) \
+        PICO_FORMAT_IS(pFormat, "%08x") ? pico_snprintf_08x(pDest, cbDest, ##__VA_ARGS__) :
+#else  // defined(PICOFORMAT_HANDLE_HEX) && defined(PICOFORMAT_HANDLE_FILL)
+    #define PICO_FORMAT_DISPATCH_08X(pDest, cbDest, pFormat, ...)
+#endif // defined(PICOFORMAT_HANDLE_HEX) && defined(PICOFORMAT_HANDLE_FILL)
+#if defined(PICOFORMAT_HANDLE_HEX)
+    #define PICO_FORMAT_DISPATCH_X(pDest, cbDest, pFormat, ...) \
+        PICO_FORMAT_IS(pFormat, "%x") ? pico_snprintf_x(pDest, cbDest, ##__VA_ARGS__) :
+#else  // PICOFORMAT_HANDLE_HEX
+    #define PICO_FORMAT_DISPATCH_X(pDest, cbDest, pFormat, ...)
+#endif // PICOFORMAT_HANDLE_HEX
+
+// the constant formats go straight to their conversion, any other format goes through the interpreter
+// the arguments are evaluated once, as for the function, whose address can still be taken
+#define pico_snprintf(pDest, cbDest, pFormat, ...) ( \
+        PICO_FORMAT_IS(pFormat, "%d") ? pico_snprintf_d(pDest, cbDest, ##__VA_ARGS__) : \
+        PICO_FORMAT_IS(pFormat, "%u") ? pico_snprintf_u(pDest, cbDest, ##__VA_ARGS__) : \
+        PICO_FORMAT_IS(pFormat, "%s") ? pico_snprintf_s(pDest, cbDest, ##__VA_ARGS__) : \
+        PICO_FORMAT_DISPATCH_X(pDest, cbDest, pFormat, ##__VA_ARGS__) \
+        PICO_FORMAT_DISPATCH_08X(pDest, cbDest, pFormat, ##__VA_ARGS__) \
+        (pico_snprintf)(pDest, cbDest, pFormat, ##__VA_ARGS__))
+#endif // __GNUC__
+#endif // PICOPRINTF_IMPLEMENTATION
+
 #endif // __picoprintf_h_INCLUDED__
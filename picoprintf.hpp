@@ -0,0 +1,382 @@
+#ifndef __picoprintf_hpp_INCLUDED__
+#define __picoprintf_hpp_INCLUDED__
+
+// C++20 front end: the format is parsed at compile time, the arguments are type-checked against it, and every call site
+// renders straight through the conversion kernels of picoprintf.c (`pico_emit_*()`), with no format interpreted at runtime:
+//
+//     char buf[64];
+//     pico::format<"sensor #%d: %s">(buf, sizeof(buf), id, status);     // same output and return value as pico_snprintf()
+//     pico::format<"sensor #%d: %s">(buf, sizeof(buf), 42L, status);    // compile error: %d expects an int, not a long
+//
+// the feature macros of picoprintf.h apply: a conversion that is not enabled there is a compile error, too
+
+#include "picoprintf.h"
+
+#include <stdint.h>     // uintptr_t
+#include <tuple>        // std::forward_as_tuple(), std::get()
+#include <type_traits>  // std::is_integral_v, etc.
+#include <utility>      // std::index_sequence
+
+
+namespace pico {
+
+// a string literal as a template argument, e.g. `pico::format<"%d">`
+template <size_t N>
+struct fixed_string {
+    char data[N];
+    constexpr fixed_string(const char (&str)[N]) {
+        for (size_t ii = 0; ii < N; ii++) {
+            data[ii] = str[ii];
+        }
+    }
+};
+
+
+namespace detail {
+
+// not constexpr on purpose: calling them from the compile-time parser makes the compiler name them in the error
+void unhandled_format_specifier();
+void incomplete_format_specifier();
+void too_many_fractional_bits();
+
+
+// one step of the format: a literal span followed by an (optional) conversion, as in `pico_format_op`
+struct op {
+    size_t iLiteral;                    // offset of the literal into the format
+    size_t cbLiteral;
+    char conversion;                    // the conversion char as written, e.g. 'x' or 'p' for `spec.format` 'b'
+    size_t iArg;                        // index of the first argument it takes: the '*' width and precision go first
+    pico_format_spec spec;              // `spec.format` is '\0' when the op is a literal only
+};
+
+
+// the same grammar as `parse_spec()` in picoprintf.c, restricted to the same feature macros
+constexpr const char *parse_spec(const char *pFormat, op *pOp) {
+    pico_format_spec &spec = pOp->spec;
+    spec = pico_format_spec{};
+    spec.decimal_chars = -1;
+    for (; '\0' == spec.format; pFormat++) {
+        pOp->conversion = *pFormat;
+        switch (*pFormat) {
+        case '\0':
+            incomplete_format_specifier();
+            break;
+    #ifdef PICOFORMAT_HANDLE_FORCEDSIGN
+        case '+':
+            spec.flags.force_sign = 1;
+            break;
+    #endif // PICOFORMAT_HANDLE_FORCEDSIGN
+    #ifdef PICOFORMAT_HANDLE_FILL
+        case '-':
+            spec.flags.left_align = 1;
+            break;
+    #endif // PICOFORMAT_HANDLE_FILL
+        case '0':
+            if (!spec.flags.seen_numbers) {
+                spec.flags.fill_zeros = 1;
+                break;
+            }
+            [[fallthrough]];
+        case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+            *(spec.flags.seen_period ? &spec.decimal_chars : &spec.whole_chars) *= 10;
+            *(spec.flags.seen_period ? &spec.decimal_chars : &spec.whole_chars) += *pFormat - '0';
+            spec.flags.seen_numbers = 1;
+            break;
+        case '.':
+            spec.flags.seen_numbers = spec.flags.seen_period = 1;
+            spec.decimal_chars = 0;
+            break;
+        case '*':
+            if (spec.flags.seen_period) {
+                spec.flags.decimal_from_arg = 1;
+            } else {
+                spec.flags.whole_from_arg = 1;
+            }
+            spec.flags.seen_numbers = 1;
+            break;
+        case 'l':
+            spec.flags.treat_as_long = 1;
+            break;
+        case 'u':
+            spec.flags.treat_as_unsigned = 1;
+            spec.format = 'd';
+            break;
+    #ifdef PICOFORMAT_HANDLE_BIN
+        case 'b':
+            spec.bits_per_digit = 1;
+            spec.flags.treat_as_unsigned = 1;
+            spec.format = 'b';
+            break;
+    #endif // PICOFORMAT_HANDLE_BIN
+    #ifdef PICOFORMAT_HANDLE_OCT
+        case 'o':
+            spec.bits_per_digit = 3;
+            spec.flags.treat_as_unsigned = 1;
+            spec.format = 'b';
+            break;
+    #endif // PICOFORMAT_HANDLE_OCT
+    #ifdef PICOFORMAT_HANDLE_HEX
+        case 'p':
+            spec.flags.treat_as_long = sizeof(void *) > sizeof(unsigned);
+            [[fallthrough]];
+        case 'x':
+            spec.flags.render_in_lowercase = 1;
+            [[fallthrough]];
+        case 'X':
+            spec.bits_per_digit = 4;
+            spec.flags.treat_as_unsigned = 1;
+            spec.format = 'b';
+            break;
+    #endif // PICOFORMAT_HANDLE_HEX
+    #ifdef PICOFORMAT_HANDLE_HEXDUMP
+        case 'H':
+            spec.format = 'H';
+            break;
+    #endif // PICOFORMAT_HANDLE_HEXDUMP
+    #ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+        case 'Q': {
+            int bits = 0;
+            for (; pFormat[1] >= '0' && pFormat[1] <= '9'; pFormat++) {
+                bits = bits * 10 + pFormat[1] - '0';
+                if (bits > 60) {
+                    too_many_fractional_bits();
+                }
+            }
+            spec.fraction_bits = (signed char)bits;
+            spec.format = 'Q';
+            break;
+        }
+    #endif // PICOFORMAT_HANDLE_FIXEDPOINT
+    #ifdef PICOFORMAT_HANDLE_FLOATS
+    #ifdef PICOFORMAT_HANDLE_EXPONENTS
+        case 'e':
+        case 'g':
+        case 'r':
+    #endif // PICOFORMAT_HANDLE_EXPONENTS
+        case 'f':
+            spec.flags.render_in_lowercase = 1;
+            spec.format = *pFormat;
+            break;
+    #ifdef PICOFORMAT_HANDLE_EXPONENTS
+        case 'E':
+        case 'G':
+    #endif // PICOFORMAT_HANDLE_EXPONENTS
+        case 'F':
+    #endif // PICOFORMAT_HANDLE_FLOATS
+        case 'c':
+        case 'd':
+        case 'i':
+        case 's':
+            spec.format = *pFormat;
+            break;
+        default:
+            unhandled_format_specifier();
+            break;
+        }
+    }
+    return pFormat;
+}
+
+
+// the same splitting as `pico_format_compile()`: walks the format, and fills `pOps` if given; returns the number of ops
+constexpr size_t parse(const char *pFormat, op *pOps) {
+    const char *pStart = pFormat;
+    size_t cOps = 0, cArgs = 0;
+    while (*pFormat) {
+        op current{};
+        current.iLiteral = pFormat - pStart;
+        for (; *pFormat && '%' != *pFormat; pFormat++);
+        if ('%' == *pFormat && '%' == pFormat[1]) {     // "%%": keep the first '%' in the literal, skip the second
+            pFormat++;
+            current.cbLiteral = pFormat - pStart - current.iLiteral;
+            pFormat++;
+        } else {
+            current.cbLiteral = pFormat - pStart - current.iLiteral;
+            if ('%' == *pFormat) {
+                pFormat = parse_spec(pFormat + 1, &current);
+            }
+        }
+        current.iArg = cArgs;
+        cArgs += current.spec.flags.whole_from_arg + current.spec.flags.decimal_from_arg + ('\0' != current.spec.format);
+        if (pOps) {
+            pOps[cOps] = current;
+        }
+        cOps++;
+    }
+    return cOps;
+}
+
+
+template <fixed_string Format>
+struct parsed {
+    static constexpr size_t cOps = parse(Format.data, nullptr);
+    struct ops {
+        op pOps[cOps ? cOps : 1];
+    };
+    static constexpr ops value = [] {
+        ops result{};
+        parse(Format.data, result.pOps);
+        return result;
+    }();
+    static constexpr size_t cArgs = [] {
+        size_t count = 0;
+        for (size_t ii = 0; ii < cOps; ii++) {
+            count += value.pOps[ii].spec.flags.whole_from_arg + value.pOps[ii].spec.flags.decimal_from_arg + ('\0' != value.pOps[ii].spec.format);
+        }
+        return count;
+    }();
+};
+
+
+// whether an argument of type `T` is what the conversion reads: the same rules as `va_arg()` in picoprintf.c, made strict
+// ('*' is the conversion of the '*' width and precision)
+template <char Conversion, bool Long, class T>
+constexpr bool accepts() {
+    using U = std::remove_cvref_t<T>;
+    switch (Conversion) {
+    case '*':
+    case 'c':
+        return std::is_integral_v<U> && sizeof(U) <= sizeof(int);
+    case 's':
+        return std::is_convertible_v<T, const char *>;
+    case 'p':
+    case 'H':
+        return std::is_pointer_v<std::decay_t<T>>;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'r':
+        return std::is_floating_point_v<U> && sizeof(U) <= sizeof(double);
+    default:                            // integers: 'l' reads 64 bits, the rest reads an int
+        return std::is_integral_v<U> && !std::is_same_v<U, bool>
+            && (Long ? sizeof(U) == sizeof(long long) : sizeof(U) <= sizeof(int));
+    }
+}
+
+
+template <class T>
+constexpr unsigned long long integer_bits(const T &val) {
+    if constexpr (std::is_signed_v<T>) {
+        return (unsigned long long)(long long)val;  // sign-extended, as `pico_emit_decimal()` expects
+    } else {
+        return (unsigned long long)val;
+    }
+}
+
+
+template <char Conversion, bool Long, class T>
+inline void emit_value(pico_out *pOut, const pico_format_spec *pSpec, const T &val) {
+    static_assert(accepts<Conversion, Long, T>(), "picoprintf: the argument type does not match its conversion (e.g. a long for %d, or an int for %ld)");
+    if constexpr ('c' == Conversion) {
+        pico_emit_char(pOut, pSpec, (int)val);
+    } else if constexpr ('s' == Conversion) {
+        pico_emit_string(pOut, pSpec, val);
+    } else if constexpr ('p' == Conversion) {
+        pico_emit_radix(pOut, pSpec, (unsigned long long)(uintptr_t)val);
+    } else if constexpr ('H' == Conversion) {
+        pico_emit_hexdump(pOut, pSpec, val);
+    } else if constexpr ('b' == Conversion || 'o' == Conversion || 'x' == Conversion || 'X' == Conversion) {
+        pico_emit_radix(pOut, pSpec, integer_bits(val));
+    } else if constexpr ('d' == Conversion || 'i' == Conversion || 'u' == Conversion) {
+        pico_emit_decimal(pOut, pSpec, integer_bits(val));
+    } else if constexpr ('Q' == Conversion) {
+        pico_emit_fixed(pOut, pSpec, integer_bits(val));
+    } else {
+        pico_emit_double(pOut, pSpec, (double)val);
+    }
+}
+
+
+template <fixed_string Format, size_t I, class Args>
+inline void emit_op(pico_out *pOut, const Args &args) {
+    static constexpr op o = parsed<Format>::value.pOps[I];
+    if constexpr (o.cbLiteral > 0) {
+        pico_emit_literal(pOut, Format.data + o.iLiteral, o.cbLiteral);
+    }
+    if constexpr ('\0' != o.spec.format) {
+        constexpr size_t iValue = o.iArg + o.spec.flags.whole_from_arg + o.spec.flags.decimal_from_arg;
+        if constexpr (o.spec.flags.whole_from_arg || o.spec.flags.decimal_from_arg) {
+            pico_format_spec spec = o.spec;     // resolving the '*' width and precision
+            if constexpr (o.spec.flags.whole_from_arg) {
+                static_assert(accepts<'*', false, std::tuple_element_t<o.iArg, Args>>(), "picoprintf: the '*' width expects an int");
+                spec.whole_chars = (int)std::get<o.iArg>(args);
+            }
+            if constexpr (o.spec.flags.decimal_from_arg) {
+                constexpr size_t iPrecision = o.iArg + o.spec.flags.whole_from_arg;
+                static_assert(accepts<'*', false, std::tuple_element_t<iPrecision, Args>>(), "picoprintf: the '*' precision expects an int");
+                spec.decimal_chars = (int)std::get<iPrecision>(args);
+            }
+            emit_value<o.conversion, 0 != o.spec.flags.treat_as_long>(pOut, &spec, std::get<iValue>(args));
+        } else {
+            emit_value<o.conversion, 0 != o.spec.flags.treat_as_long>(pOut, &o.spec, std::get<iValue>(args));
+        }
+    }
+}
+
+
+template <fixed_string Format, class... Args, size_t... I>
+inline int render(pico_out *pOut, std::index_sequence<I...>, const Args &... args) {
+    static_assert(parsed<Format>::cArgs == sizeof...(Args), "picoprintf: the number of arguments does not match the format");
+    auto tuple = std::forward_as_tuple(args...);
+    (emit_op<Format, I>(pOut, tuple), ...);
+    return (int)(pOut->cbCounted + (pOut->pDest - pOut->pChunk));
+}
+
+
+template <size_t I, class... Args>
+using nth = std::tuple_element_t<I, std::tuple<const Args &...>>;
+
+template <fixed_string Format, size_t I, class... Args>
+constexpr bool op_matches() {
+    constexpr op o = parsed<Format>::value.pOps[I];
+    if constexpr ('\0' == o.spec.format) {
+        return true;
+    } else {
+        constexpr size_t iValue = o.iArg + o.spec.flags.whole_from_arg + o.spec.flags.decimal_from_arg;
+        bool match = accepts<o.conversion, 0 != o.spec.flags.treat_as_long, nth<iValue, Args...>>();
+        if constexpr (o.spec.flags.whole_from_arg) {
+            match = match && accepts<'*', false, nth<o.iArg, Args...>>();
+        }
+        if constexpr (o.spec.flags.decimal_from_arg) {
+            match = match && accepts<'*', false, nth<o.iArg + o.spec.flags.whole_from_arg, Args...>>();
+        }
+        return match;
+    }
+}
+
+template <fixed_string Format, class... Args, size_t... I>
+constexpr bool arguments_match(std::index_sequence<I...>) {
+    if constexpr (parsed<Format>::cArgs != sizeof...(Args)) {
+        return false;
+    } else {
+        return (op_matches<Format, I, Args...>() && ...);
+    }
+}
+
+} // namespace detail
+
+
+// whether `pico::format<Format>()` compiles with these argument types, e.g. for `static_assert()` or `requires`
+template <fixed_string Format, class... Args>
+inline constexpr bool arguments_match = detail::arguments_match<Format, Args...>(std::make_index_sequence<detail::parsed<Format>::cOps>{});
+
+
+// same output and return value as `pico_snprintf()`
+template <fixed_string Format, class... Args>
+inline int format(char *pDest, size_t cbDest, const Args &... args) {
+    pico_out out = { pDest, cbDest ? pDest + cbDest - 1 : pDest, pDest, nullptr, nullptr, nullptr, 0 };
+    int result = detail::render<Format>(&out, std::make_index_sequence<detail::parsed<Format>::cOps>{}, args...);
+    if (cbDest) {
+        *out.pDest = '\0';
+    }
+    return result;
+}
+
+
+// same as `pico_measure()`
+template <fixed_string Format, class... Args>
+inline int measure(const Args &... args) {
+    pico_out out = {};
+    return detail::render<Format>(&out, std::make_index_sequence<detail::parsed<Format>::cOps>{}, args...);
+}
+
+} // namespace pico
+
+#endif // __picoprintf_hpp_INCLUDED__
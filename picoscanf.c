@@ -0,0 +1,262 @@
+#include "picoscanf.h"
+#include "picoatox.h"
+#include "picobool.h"
+
+#include <stdint.h> // intmax_t
+
+
+// a field width copies the number out, for the kernels to stop at its end: wider ones are cut at this size minus one
+#define FIELD_SIZE 64
+
+#define IS_SPACE(ch) (' ' == (ch) || ((ch) >= '\t' && (ch) <= '\r'))
+
+
+// stores `val` through `pDest` as the type of the length modifier: 'H' for "hh", 'L' for "ll" (and 'L'), 0 for none
+static void store_integer(void *pDest, char length, unsigned long long val) {
+    switch (length) {
+    case 'H':
+        *(signed char *)pDest = (signed char)val;
+        break;
+    case 'h':
+        *(short *)pDest = (short)val;
+        break;
+    case 'l':
+        *(long *)pDest = (long)val;
+        break;
+    case 'L':
+        *(long long *)pDest = (long long)val;
+        break;
+    case 'j':
+        *(intmax_t *)pDest = (intmax_t)val;
+        break;
+    case 'z':
+        *(size_t *)pDest = (size_t)val;
+        break;
+    case 't':
+        *(ptrdiff_t *)pDest = (ptrdiff_t)val;
+        break;
+    default:
+        *(int *)pDest = (int)val;
+        break;
+    }
+}
+
+
+// the number at `pStr` as the kernels see it: in place, or copied out and cut at `width` chars if there is one
+static const char *number_field(const char *pStr, int width, char *pField) {
+    if (width <= 0) {
+        return pStr;
+    }
+    int len = 0;
+    for (; len < width && len < FIELD_SIZE - 1 && pStr[len]; len++) {
+        pField[len] = pStr[len];
+    }
+    pField[len] = '\0';
+    return pField;
+}
+
+
+// whether `ch` is in the scan set between `pSet` and `pSetEnd`, e.g. "a-z_" (the '-' is literal first or last)
+static bool in_scan_set(const char *pSet, const char *pSetEnd, char ch) {
+    for (const char *pCur = pSet; pCur < pSetEnd; pCur++) {
+        if ('-' == pCur[1] && pCur + 2 < pSetEnd) {
+            if ((unsigned char)ch >= (unsigned char)pCur[0] && (unsigned char)ch <= (unsigned char)pCur[2]) {
+                return true;
+            }
+            pCur += 2;
+        } else if (ch == *pCur) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+int pico_vsscanf(const char *pStr, const char *pFormat, va_list vl) {
+    const char *pCur = pStr;
+    int assigned = 0;
+    bool converted = false;                         // a conversion succeeded, so an early end is no longer `EOF`
+    bool ended = false;                             // the input ended before the format did
+    while (*pFormat) {
+        if (IS_SPACE(*pFormat)) {                   // whitespace matches any amount of it, none included
+            for (; IS_SPACE(*pFormat); pFormat++);
+            for (; IS_SPACE(*pCur); pCur++);
+            continue;
+        }
+        if ('%' != *pFormat || '%' == pFormat[1]) { // a literal char, "%%" included, which skips the whitespace before
+            if ('%' == *pFormat) {
+                for (; IS_SPACE(*pCur); pCur++);
+                pFormat++;
+            }
+            if (*pCur != *pFormat) {
+                ended = '\0' == *pCur;
+                break;
+            }
+            pCur++;
+            pFormat++;
+            continue;
+        }
+
+        pFormat++;
+        bool suppress = '*' == *pFormat;
+        pFormat += suppress;
+        int width = 0;
+        for (; *pFormat >= '0' && *pFormat <= '9'; pFormat++) {
+            width = width * 10 + (*pFormat - '0');
+        }
+        char length = 0;
+        switch (*pFormat) {
+        case 'h':
+        case 'l':
+            length = pFormat[1] == *pFormat ? *pFormat++ & ~0x20 : *pFormat;   // "hh" is 'H', "ll" is 'L'
+            pFormat++;
+            break;
+        case 'L':
+        case 'j':
+        case 'z':
+        case 't':
+            length = *pFormat++;
+            break;
+        }
+        char conversion = *pFormat++;
+        void *pDest = suppress || 'n' == conversion ? NULL : va_arg(vl, void *);
+        if ('n' == conversion) {                    // not a conversion: neither counted nor failing
+            if (!suppress) {
+                store_integer(va_arg(vl, void *), length, (unsigned long long)(pCur - pStr));
+            }
+            continue;
+        }
+        if ('c' != conversion && '[' != conversion) {
+            for (; IS_SPACE(*pCur); pCur++);
+        }
+        if ('\0' == *pCur) {
+            ended = true;
+            break;
+        }
+
+        char pField[FIELD_SIZE];
+        const char *pEnd = pCur;
+        int base = -1;
+        switch (conversion) {
+        case 'd':
+        case 'u':
+            base = 10;
+            break;
+        case 'i':
+            base = 0;
+            break;
+    #ifdef PICOFORMAT_HANDLE_BIN
+        case 'b':
+            base = 2;
+            break;
+    #endif // PICOFORMAT_HANDLE_BIN
+    #ifdef PICOFORMAT_HANDLE_OCT
+        case 'o':
+            base = 8;
+            break;
+    #endif // PICOFORMAT_HANDLE_OCT
+    #ifdef PICOFORMAT_HANDLE_HEX
+        case 'p':
+            length = sizeof(void *) == sizeof(long) ? 'l' : 'L';   // the same bits as a `void *`
+            // fall through
+        case 'x':
+        case 'X':
+            base = 16;
+            break;
+    #endif // PICOFORMAT_HANDLE_HEX
+    #ifdef PICOFORMAT_HANDLE_FLOATS
+        case 'e':
+        case 'f':
+        case 'g':
+        case 'E':
+        case 'F':
+        case 'G': {
+            const char *pNumber = number_field(pCur, width, pField);
+            if ('l' == length || 'L' == length) {   // a `long double` only gets the precision of a `double`
+                double val = pico_strtod(pNumber, &pEnd);
+                if (pDest && pEnd > pNumber && 'l' == length) {
+                    *(double *)pDest = val;
+                } else if (pDest && pEnd > pNumber) {
+                    *(long double *)pDest = val;
+                }
+            } else {                                // rounded once, straight to a `float`
+                float val = pico_strtof(pNumber, &pEnd);
+                if (pDest && pEnd > pNumber) {
+                    *(float *)pDest = val;
+                }
+            }
+            pEnd = pCur + (pEnd - pNumber);
+            break;
+        }
+    #endif // PICOFORMAT_HANDLE_FLOATS
+        case 'c':                                   // `width` chars (1 by default, fewer at the end), without a null-terminator
+            for (width = width ? width : 1; pEnd < pCur + width && *pEnd; pEnd++) {
+                if (pDest) {
+                    ((char *)pDest)[pEnd - pCur] = *pEnd;
+                }
+            }
+            break;
+        case 's':
+        case '[': {
+            bool negate = false;
+            const char *pSet = pFormat;
+            const char *pSetEnd = pFormat;
+            if ('[' == conversion) {                // "[abc]", "[^abc]", "[]abc]", "[a-z]"
+                negate = '^' == *pFormat;
+                pSet = pFormat += negate;
+                pFormat += ']' == *pFormat;
+                for (; *pFormat && ']' != *pFormat; pFormat++);
+                pSetEnd = pFormat;
+                pFormat += ']' == *pFormat;
+            }
+            for (; *pEnd && (!width || pEnd < pCur + width); pEnd++) {
+                if ('s' == conversion ? IS_SPACE(*pEnd) : in_scan_set(pSet, pSetEnd, *pEnd) == negate) {
+                    break;
+                }
+                if (pDest) {
+                    ((char *)pDest)[pEnd - pCur] = *pEnd;
+                }
+            }
+            if (pDest && pEnd > pCur) {
+                ((char *)pDest)[pEnd - pCur] = '\0';
+            }
+            break;
+        }
+        default:
+            FORMAT_ERROR_DELEGATE("detected unhandled scan specifier: %c", conversion);
+            break;
+        }
+
+        if (base >= 0) {
+            const char *pNumber = number_field(pCur, width, pField);
+            unsigned long long val = pico_strtou64(pNumber, &pEnd, base, NULL);
+    #ifndef PICOFORMAT_HANDLE_BIN
+            const char *pZero = pNumber + ('-' == *pNumber || '+' == *pNumber);
+            if (0 == base && '0' == pZero[0] && 'b' == (pZero[1] | 0x20)) {    // no "0b" prefix without BIN, as in glibc
+                val = 0;
+                pEnd = pZero + 1;
+            }
+    #endif // PICOFORMAT_HANDLE_BIN
+            if (pDest && pEnd > pNumber) {
+                store_integer(pDest, length, val);
+            }
+            pEnd = pCur + (pEnd - pNumber);
+        }
+        if (pEnd == pCur) {                         // a matching failure
+            break;
+        }
+        pCur = pEnd;
+        assigned += NULL != pDest;
+        converted = true;
+    }
+    return ended && !converted ? -1 : assigned;
+}
+
+
+int pico_sscanf(const char *pStr, const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    int result = pico_vsscanf(pStr, pFormat, vl);
+    va_end(vl);
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef __picoscanf_h_INCLUDED__
+#define __picoscanf_h_INCLUDED__
+
+// the counterpart of `sscanf()`, without locales, `errno`, or allocations: the conversions are gated by the same
+// `PICOFORMAT_HANDLE_*` macros as picoprintf's (see picoprintf.h), and parsed by the picoatox.h kernels
+//   "%d", "%i", "%u", "%c", "%s", "%[...]", "%n", "%%":  always
+//   "%x", "%X", "%p":                                   `PICOFORMAT_HANDLE_HEX`
+//   "%o":                                               `PICOFORMAT_HANDLE_OCT`
+//   "%b" (non-standard: binary, "0b" prefix allowed):   `PICOFORMAT_HANDLE_BIN`, which also makes "0b" a prefix of "%i"
+//   "%f", "%e", "%g", "%F", "%E", "%G":                 `PICOFORMAT_HANDLE_FLOATS` (decimal only, no hexadecimal floats)
+// with the standard '*' (parse, but do not assign), field widths, and length modifiers "hh", "h", "l", "ll", "L", "j",
+// "z", "t": unlike picoprintf, where 'l' always means 64 bits, here they store through exactly the pointer types of C
+// a field width cuts the numbers at up to 63 chars; "%s" and "%[" without a width do not bound their destination
+// "%n" stores the number of chars consumed so far, e.g. at the end of the format to find where the parsing stopped
+
+#include "picoprintf.h"
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// returns the number of fields assigned, or -1 (`EOF`) if the input ended before the first conversion
+int pico_sscanf(const char *pStr, const char *pFormat, ...);
+int pico_vsscanf(const char *pStr, const char *pFormat, va_list vl);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __picoscanf_h_INCLUDED__
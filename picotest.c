@@ -1,4 +1,8 @@
 #include "picoprintf.h"
+#include "picolog.h"
+#include "picoatox.h"
+#include "picoscanf.h"
+#include "picoio.h"
 
 #include <stdbool.h>
 #include <stdio.h>  // printf() for messages and snprintf() for comparison
@@ -6,9 +10,13 @@
 #include <stdlib.h> // rand() and srand()
 #include <time.h>   // time
 #include <math.h>   // INFINITY, NaN, etc.
+#include <errno.h>  // ERANGE from strtoll() and strtoull()
+#include <fcntl.h>  // O_NONBLOCK and O_APPEND for the picoio tests
+#include <unistd.h> // pipe(), read(), lseek()
+#include <pthread.h>
+#include <wchar.h>  // wint_t, of "%lc"
 
 // TODO: add the following failure or near-failure tests:
-// * too small of a buffer
 // * incorrect formats, like "%4. "
 // * non-existing formats, like "%q"
 
@@ -18,11 +26,174 @@ char pPicoBuf[0x200];
 
 bool g_verbose = false;
 
+pico_compiled_fmt compiled;
+pico_format_op pCompiledOps[16];
+
+size_t cbSunk;
+
+// collects the output of `pico_fctprintf()` into `pPicoBuf`
+void sink(void *pCtx, const char *pSrc, size_t cbSrc) {
+    for (size_t ii = 0; ii < cbSrc && cbSunk < sizeof(pPicoBuf) - 1; ii++) {
+        pPicoBuf[cbSunk++] = pSrc[ii];
+    }
+}
+
+
+// reads what the non-blocking `fd` has so far into `pPicoBuf`: an empty string if nothing was written yet
+int read_written(int fd) {
+    int cbRead = 0;
+    for (ssize_t cb; (cb = read(fd, pPicoBuf + cbRead, sizeof(pPicoBuf) - 1 - cbRead)) > 0; cbRead += (int)cb);
+    pPicoBuf[cbRead] = '\0';
+    return cbRead;
+}
+
+
+#define IO_THREADS 4
+#define IO_THREAD_LINES 5000
+int g_ioFd;
+
+// logs numbered lines to `g_ioFd` concurrently with the other threads, fully buffered
+void *log_lines(void *pArg) {
+    pico_set_flush_policy(PICOIO_FLUSH_FULL);
+    for (int ii = 0; ii < IO_THREAD_LINES; ii++) {
+        pico_dprintf(g_ioFd, "thread %d line %d: %.*s\n", (int)(size_t)pArg, ii, ii % 40, "padding to vary the length of the lines");
+    }
+    return NULL;                                    // the rest is flushed at the exit of the thread
+}
+
+
+#ifdef PICOFORMAT_STATS
+#define STATS_THREAD_LINES 1000
+
+// formats into a buffer of its own, for its counts to land in a slot of their own
+void *format_lines(void *pArg) {
+    char pBuf[32];
+    for (int ii = 0; ii < STATS_THREAD_LINES; ii++) {
+        pico_snprintf(pBuf, sizeof(pBuf), "line %d", ii);
+    }
+    return pArg;
+}
+#endif // PICOFORMAT_STATS
+
+
+// renders through `pico_fmt_next()` in chunks of `cbChunk` (up to 64) into `pPicoBuf`, checking that every chunk but the
+// last one is full, that no chunk is overrun, and that the state is done after the last one; returns the length of the
+// output, or -1 on a failed check
+int render_chunked(size_t cbChunk, const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    pico_fmt_state state;
+    pico_fmt_begin(&state, pFormat, vl);
+    size_t cbDone = 0;
+    bool failed = false;
+    for (bool done = false; !done && !failed; ) {
+        char pChunk[65];
+        memset(pChunk, '#', sizeof(pChunk));
+        size_t cbFilled = pico_fmt_next(&state, pChunk, cbChunk);
+        done = NULL == state.pFormat;
+        failed = cbFilled > cbChunk || (!done && cbFilled != cbChunk) || '#' != pChunk[cbFilled] || cbDone + cbFilled >= sizeof(pPicoBuf);
+        memcpy(pPicoBuf + cbDone, pChunk, failed ? 0 : cbFilled);
+        cbDone += cbFilled;
+    }
+    failed = failed || 0 != pico_fmt_next(&state, pStdBuf, cbChunk);
+    va_end(vl);
+    pPicoBuf[failed ? 0 : cbDone] = '\0';
+    return failed ? -1 : (int)cbDone;
+}
+
+
+// the same into `pDest`, in chunks of 64 up to `cbDest`, for the longer outputs; returns their length
+int render_long_chunked(char *pDest, size_t cbDest, const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    pico_fmt_state state;
+    pico_fmt_begin(&state, pFormat, vl);
+    size_t cbDone = 0;
+    while (state.pFormat && cbDone + 64 < cbDest) {
+        cbDone += pico_fmt_next(&state, pDest + cbDone, 64);
+    }
+    pico_fmt_end(&state);
+    va_end(vl);
+    pDest[cbDone] = '\0';
+    return (int)cbDone;
+}
+
+
+// renders the first 4 chars of the output into `pPicoBuf`, then abandons the rest; returns what the next chunk gets then
+size_t abandon_chunked(const char *pFormat, ...) {
+    va_list vl;
+    va_start(vl, pFormat);
+    pico_fmt_state state;
+    pico_fmt_begin(&state, pFormat, vl);
+    pico_fmt_next(&state, pPicoBuf, 4);
+    pPicoBuf[4] = '\0';
+    pico_fmt_end(&state);
+    pico_fmt_end(&state);                       // a no-op once ended
+    size_t cbLeft = pico_fmt_next(&state, pPicoBuf + 5, 4);
+    va_end(vl);
+    return cbLeft;
+}
+
+
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+// the reference of "%T": the calendar of the libc, and the fraction truncated to `precision` digits
+int std_timestamp(char *pDest, size_t cbDest, time_t second, long nanosecond, int precision) {
+    struct tm tm;
+    gmtime_r(&second, &tm);
+    int len = snprintf(pDest, cbDest, "%04d-%02d-%02dT%02d:%02d:%02d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    if (precision) {
+        long fraction = nanosecond;
+        for (int ii = 9; ii > precision; ii--) {
+            fraction /= 10;
+        }
+        len += snprintf(pDest + len, cbDest - len, ".%0*ld", precision, fraction);
+    }
+    return len + snprintf(pDest + len, cbDest - len, "Z");
+}
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+
+
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+// "%I": an IPv4 address in host order, rendered octet by octet straight into the output
+void convert_ipv4(pico_out *pOut, const pico_format_spec *pSpec, va_list *pvl) {
+    (void)pSpec;
+    unsigned address = va_arg(*pvl, unsigned);
+    pico_format_spec octet = {0};
+    octet.format = 'd';
+    octet.decimal_chars = -1;
+    octet.flags.treat_as_unsigned = 1;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        pico_emit_decimal(pOut, &octet, (address >> shift) & 0xff);
+        if (shift) {
+            pico_emit_literal(pOut, ".", 1);
+        }
+    }
+}
+
+
+// "%N": the name of a level, with the width and the precision of "%s"
+void convert_level(pico_out *pOut, const pico_format_spec *pSpec, va_list *pvl) {
+    static const char *pNames[] = { "debug", "info", "warning", "error" };
+    unsigned level = va_arg(*pvl, unsigned);
+    pico_emit_string(pOut, pSpec, level < 4 ? pNames[level] : "?");
+}
+#endif // PICOFORMAT_HANDLE_CUSTOM
+
 
 #define RUN_TEST(format, ...) \
-    snprintf(pStdBuf, 0x200, format, __VA_ARGS__); \
-    pico_snprintf(pPicoBuf, 0x200, format, __VA_ARGS__); \
-    failed = strcmp(pStdBuf, pPicoBuf); \
+    stdlen = snprintf(pStdBuf, 0x200, format, __VA_ARGS__); \
+    picolen = pico_snprintf(pPicoBuf, 0x200, format, __VA_ARGS__); \
+    failed = strcmp(pStdBuf, pPicoBuf) || stdlen != picolen || stdlen != pico_snprintf(NULL, 0, format, __VA_ARGS__); \
+    if (!failed && pico_format_compile(format, &compiled, pCompiledOps, 16) >= 0) { /* the compiled format must match, too */ \
+        pico_format_render(&compiled, pPicoBuf, 0x200, __VA_ARGS__); \
+        failed = strcmp(pStdBuf, pPicoBuf); \
+    } \
+    if (!failed) {                                  /* and so must the streamed output */ \
+        cbSunk = 0; \
+        pico_fctprintf(sink, NULL, format, __VA_ARGS__); \
+        pPicoBuf[cbSunk] = '\0'; \
+        failed = strcmp(pStdBuf, pPicoBuf); \
+    } \
     if (g_verbose || failed) { \
         printf("picoprintf %s  \"%s\", -- stdlib result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", format, pStdBuf, pPicoBuf); \
     } \
@@ -33,6 +204,76 @@ bool g_verbose = false;
     }
 
 
+// same as `RUN_TEST()`, but into a buffer of `size` chars, to verify the truncation
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wformat-truncation"    // the truncation is intended
+#endif // gcc
+#define RUN_TRUNCATED_TEST(size, format, ...) \
+    stdlen = snprintf(pStdBuf, size, format, __VA_ARGS__); \
+    picolen = pico_snprintf(pPicoBuf, size, format, __VA_ARGS__); \
+    failed = strcmp(pStdBuf, pPicoBuf) || stdlen != picolen; \
+    if (g_verbose || failed) { \
+        printf("picoprintf %s  \"%s\" truncated to %d chars, -- stdlib result: \"%s\" (%d), picoprintf result: \"%s\" (%d)\n", failed ? "FAILED" : "passed", format, size, pStdBuf, stdlen, pPicoBuf, picolen); \
+    } \
+    if (failed) { \
+        picofailures++; \
+    } else { \
+        picopasses++; \
+    }
+
+
+// `pico_sscanf()` against `sscanf()`: the same result, the same value in `type`, and the same end ("%n")
+// the string conversions take a `char[16]`, and the others a `type`
+#define RUN_SCANF_TEST(type, input, format) { \
+        typedef type scanned_type;                  /* for the pointer types */ \
+        scanned_type stdValue, picoValue; \
+        int stdEnd = -1, picoEnd = -1; \
+        memset(&stdValue, 0x5a, sizeof(stdValue)); \
+        memset(&picoValue, 0x5a, sizeof(picoValue)); \
+        int stdResult = sscanf(input, format "%n", &stdValue, &stdEnd); \
+        int picoResult = pico_sscanf(input, format "%n", &picoValue, &picoEnd); \
+        failed = stdResult != picoResult || stdEnd != picoEnd || memcmp(&stdValue, &picoValue, sizeof(stdValue)); \
+        if (g_verbose || failed) { \
+            printf("picoscanf %s  \"%s\" from \"%s\", -- stdlib result: %d (end %d), picoscanf result: %d (end %d)\n", failed ? "FAILED" : "passed", format, input, stdResult, stdEnd, picoResult, picoEnd); \
+        } \
+        failed ? picofailures++ : picopasses++; \
+    }
+#define RUN_SCANF_STRING_TEST(input, format) { \
+        char stdValue[16], picoValue[16]; \
+        int stdEnd = -1, picoEnd = -1; \
+        memset(stdValue, 0x5a, sizeof(stdValue)); \
+        memset(picoValue, 0x5a, sizeof(picoValue)); \
+        int stdResult = sscanf(input, format "%n", stdValue, &stdEnd); \
+        int picoResult = pico_sscanf(input, format "%n", picoValue, &picoEnd); \
+        failed = stdResult != picoResult || stdEnd != picoEnd || memcmp(stdValue, picoValue, sizeof(stdValue)); \
+        if (g_verbose || failed) { \
+            printf("picoscanf %s  \"%s\" from \"%s\", -- stdlib result: %d (end %d), picoscanf result: %d (end %d)\n", failed ? "FAILED" : "passed", format, input, stdResult, stdEnd, picoResult, picoEnd); \
+        } \
+        failed ? picofailures++ : picopasses++; \
+    }
+
+
+unsigned char pLogBuf[1024];
+pico_log_ring logRing;
+
+// same as `RUN_TEST()`, but captured into `logRing` and rendered from there
+#define RUN_LOG_TEST(format, ...) \
+    stdlen = snprintf(pStdBuf, 0x200, format, __VA_ARGS__); \
+    failed = pico_log_capture(&logRing, format, __VA_ARGS__) < 0; \
+    cbSunk = 0; \
+    failed = failed || 1 != pico_log_render(&logRing, sink, NULL); \
+    pPicoBuf[cbSunk] = '\0'; \
+    failed = failed || strcmp(pStdBuf, pPicoBuf); \
+    if (g_verbose || failed) { \
+        printf("picoprintf %s  logged \"%s\", -- stdlib result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", format, pStdBuf, pPicoBuf); \
+    } \
+    if (failed) { \
+        picofailures++; \
+    } else { \
+        picopasses++; \
+    }
+
+
 #ifdef __RUN_COMPARISON_TESTS__
 // comparison tests require cloning the following projects into the same directory
 #include "mpaland.h"
@@ -52,7 +293,7 @@ const char* g_pIntegerFormats[] = {
     "%x", "%X",
 #endif // PICOFORMAT_HANDLE_HEX
 #ifdef PICOFORMAT_HANDLE_FILL
-    "%6i", "%05d", "%2u",
+    "%6i", "%05d", "%2u", "%-6i",
 #ifdef PICOFORMAT_HANDLE_OCT
     "%10d", "%3o",
 #endif // PICOFORMAT_HANDLE_OCT
@@ -90,6 +331,83 @@ float g_testFloats[] = {
     0, 1, -1, 3.14, -M_PI, 13.07, 1000 * 1000 * 42 + 0.582, INFINITY, -INFINITY, NAN, -NAN
 };
 
+// the float conversion is exact, so it must match glibc digit for digit, rounding and all
+const char* g_pDoubleFormats[] = {
+    "%f", "%.0f", "%.1f", "%.3f", "%.20f", "%F",
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+    "%e", "%.0e", "%.3e", "%.16e", "%E",
+    "%g", "%.0g", "%.3g", "%.10g", "%.17g", "%G",
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+#ifdef PICOFORMAT_HANDLE_FILL
+    "%12.3f", "%-12.3f|", "%012.3f",
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+    "%14.4e", "%-14.4e|", "%014.4e", "%12g",
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_FORCEDSIGN
+    "%+.2f",
+#endif // PICOFORMAT_HANDLE_FORCEDSIGN
+    NULL  // keep it last
+};
+
+double g_testDoubles[] = {
+    0., -0., 0.5, 1.5, 2.5, -2.5, 0.125, 0.1, 0.3, 2. / 3., 9.9999999, 99.95, 999999.5, 0.00001234, 1e-5, 0.0001,
+    123456789., 4294967296., 1e15, 1e16, 1e17, 1e21, 1e22, 1e23, 9007199254740993., 1.7976931348623157e308,
+    2.2250738585072014e-308, 4.9e-324, 1e-300, 6.02214076e23, 1.602176634e-19, INFINITY, -INFINITY, NAN
+};
+
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+// "%Q" is exact, so it must match "%Lf" of the same value: a `long double` holds any of them exactly
+typedef struct {
+    const char *pFixed;
+    const char *pFloat;
+    int bits;
+    bool isLong;
+} fixed_format;
+
+fixed_format g_pFixedFormats[] = {
+    { "%Q16", "%Lf", 16, false }, { "%Q0", "%Lf", 0, false }, { "%.0Q1", "%.0Lf", 1, false }, { "%.1Q1", "%.1Lf", 1, false },
+    { "%.0Q4", "%.0Lf", 4, false }, { "%.3Q15", "%.3Lf", 15, false }, { "%.4Q8", "%.4Lf", 8, false },
+    { "x=%.2Q28 y", "x=%.2Lf y", 28, false }, { "%.2Q29", "%.2Lf", 29, false }, { "%.20Q31", "%.20Lf", 31, false },
+    { "%lQ32", "%Lf", 32, true }, { "%.0lQ60", "%.0Lf", 60, true }, { "%.9lQ45", "%.9Lf", 45, true }, { "%.70lQ60", "%.70Lf", 60, true },
+#ifdef PICOFORMAT_HANDLE_FILL
+    { "%12.3Q16", "%12.3Lf", 16, false }, { "%-12.3Q16|", "%-12.3Lf|", 16, false }, { "%012.3Q16", "%012.3Lf", 16, false },
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_FORCEDSIGN
+    { "%+.2Q16", "%+.2Lf", 16, false },
+#endif // PICOFORMAT_HANDLE_FORCEDSIGN
+    { NULL }  // keep it last
+};
+
+long long g_testFixed[] = {
+    0, 1, -1, 2, 3, -3, 5, 0x8000, -0x8000, 0x18000, 0x28000, 0x7fffffff, -0x7fffffff - 1, 0x7fff, 0x10000, -0x10000,
+    0x0fffffff, 0x1fffffff, 0x0800000000000000ll, 0x7fffffffffffffffll, -0x7fffffffffffffffll - 1
+};
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+
+
+// parsed by `pico_strtoi32()` and `pico_strtou64()`, and by `strtoll()` and `strtoull()` for comparison
+const char* g_pIntegerStrings[] = {
+    "0", "7", "-7", "+7", "  \t42x", "12345678", "123456789", "-2147483648", "-2147483649", "2147483647", "2147483648",
+    "4294967296", "18446744073709551615", "18446744073709551616", "-18446744073709551615", "99999999999999999999999",
+    "000000000000000000000000012", "0x1F", "0XdeadBEEF", "0x", "0xg", "017", "08", "1e5", "", " ", "-", "+-1", "abc", "zz",
+    NULL  // keep it last
+};
+
+// parsed by `pico_strtod()` and `pico_strtof()`, and by `strtod()` and `strtof()` for comparison, bit for bit
+const char* g_pDoubleStrings[] = {
+    "0", "-0", "1", "1.5", ".5", "5.", ".", "-.e1", "  +3.25e2x", "1e", "1e+", "1e-5", "1.e2", "0e99999", "1e400", "-1e-400",
+    "inf", "-Infinity", "infin", "nan", "-NaN", "nan(", "9007199254740993", "9007199254740992.5", "0.1", "0.30000000000000004",
+    "123456789012345678901234567890", "00000000000000000000000000001.5", "0.000000000000000000000000000000000001",
+    "2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324", "2.4703282292062327e-324",
+    "2.4703282292062328e-324", "1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308",
+    "3.4028235e38", "3.4028236e38", "1.17549435e-38", "1.4e-45", "7e-46", "7.1e-46", "16777217", "1e99999999999",
+    "1.00000000000000011102230246251565404236316680908203125",    // exactly halfway between 1 and the next double: even
+    "1.00000000000000011102230246251565404236316680908203125000000000000000000000000001",   // just above it
+    "7.006492321624085354618647916449580656401e-46",               // halfway between 0 and the smallest float
+    NULL  // keep it last
+};
+
 
 const char* g_pStringFormats[] = {
     "%s",
@@ -112,6 +430,7 @@ int main(int argc, const char ** argv) {
     unsigned picopasses = 0, picofailures = 0;
     unsigned mpalandpasses = 0, mpalandfailures = 0;
     int failed;
+    int stdlen, picolen;
     // RUN_TEST("hello, world!");  // can't do that: limitation of RUN_TEST variadic expansion
     RUN_TEST("%s", "");
     RUN_TEST("%s", "x");
@@ -133,6 +452,693 @@ int main(int argc, const char ** argv) {
 #endif // PICOFORMAT_HANDLE_FLOATS
 #endif // PICOFORMAT_HANDLE_FILL
 
+    // 64-bit extremes of the `l`/`ll` modifiers
+    RUN_TEST("%lld", 0x7fffffffffffffffll);
+    RUN_TEST("%lld", -0x7fffffffffffffffll - 1);
+    RUN_TEST("%llu", 0xffffffffffffffffull);
+    RUN_TEST("%llu", 100000000ull * 100000000ull);
+    RUN_TEST("%ld", -4294967296l);
+
+#ifdef PICOFORMAT_HANDLE_HEX
+    // 64-bit and fixed-width hex
+    RUN_TEST("%llx", 0xffffffffffffffffull);
+    RUN_TEST("%llX", 0x123456789abcdefull);
+    RUN_TEST("%llx", 0x100000000ull);
+#ifdef PICOFORMAT_HANDLE_FILL
+    RUN_TEST("%016llx", 0x123456789abcdefull);
+    RUN_TEST("%016llX", 0ull);
+    RUN_TEST("%016llx", 0xabcdull);
+    RUN_TEST("%020llx", 0xfedcba9876543210ull);
+    RUN_TEST("%12llx|%-12llx|", 0xabcdef012ull, 0xabcdef012ull);
+#endif // PICOFORMAT_HANDLE_FILL
+    // pointers are as wide as it takes
+    pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%p", (void *)pPicoBuf);
+    snprintf(pStdBuf, sizeof(pStdBuf), "%llx", (unsigned long long)(size_t)pPicoBuf);
+    failed = strcmp(pStdBuf, pPicoBuf);
+    if (g_verbose || failed) {
+        printf("picoprintf %s  \"%%p\", -- expected: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf, pPicoBuf);
+    }
+    failed ? picofailures++ : picopasses++;
+#endif // PICOFORMAT_HANDLE_HEX
+
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+    // hex dumps: compared to a "%02X" per byte, over the lengths that take the bulk, the 4-byte, and the byte-by-byte paths
+    unsigned char pBytes[150];
+    for (size_t ii = 0; ii < sizeof(pBytes); ii++) {
+        pBytes[ii] = (unsigned char)(ii * 37 + 11);
+    }
+    size_t pDumpLengths[] = { 0, 1, 3, 4, 5, 15, 16, 17, 35, 64, 150 };
+    for (size_t ii = 0; ii < sizeof(pDumpLengths) / sizeof(pDumpLengths[0]); ii++) {
+        size_t len = pDumpLengths[ii];
+        for (unsigned flags = 0; flags < 4; flags++) {
+            int cbExpected = 0;
+            for (size_t jj = 0; jj < len; jj++) {
+                cbExpected += snprintf(pStdBuf + cbExpected, sizeof(pStdBuf) - cbExpected, (flags & PICO_HEXDUMP_SPACED) && jj ? " %02x" : "%02x", pBytes[jj]);
+                if (flags & PICO_HEXDUMP_UPPERCASE) {
+                    snprintf(pStdBuf + cbExpected - 2, 3, "%02X", pBytes[jj]);
+                }
+            }
+            pStdBuf[cbExpected] = '\0';
+            picolen = pico_hexdump(pPicoBuf, sizeof(pPicoBuf), pBytes, len, flags);
+            failed = strcmp(pStdBuf, pPicoBuf) || cbExpected != picolen || cbExpected != pico_hexdump(NULL, 0, pBytes, len, flags);
+            if (!failed && cbExpected > 3) {        // truncated: a prefix, and still the whole length
+                picolen = pico_hexdump(pPicoBuf, 4, pBytes, len, flags);
+                failed = strncmp(pStdBuf, pPicoBuf, 3) || '\0' != pPicoBuf[3] || cbExpected != picolen;
+            }
+            if (!failed && PICO_HEXDUMP_UPPERCASE == flags) {
+                picolen = pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%*H", (int)len, pBytes);
+                failed = strcmp(pStdBuf, pPicoBuf) || cbExpected != picolen;
+            }
+            if (g_verbose || failed) {
+                printf("picoprintf %s  hex dump of %u bytes, flags %u -- expected: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", (unsigned)len, flags, pStdBuf, pPicoBuf);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+    }
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+
+    // deferred logging: the same output as rendered right away, once in the single-producer, and once in the multi-producer mode
+    for (unsigned flags = 0; flags <= PICO_LOG_MULTI_PRODUCER; flags++) {
+        pico_log_init(&logRing, pLogBuf, sizeof(pLogBuf), flags);
+        RUN_LOG_TEST("[%s] temperature sensor #%d reports %d at tick %u", "info", 7, -1234, 4000000000u);
+        RUN_LOG_TEST("%lld|%llu|%c|%.3s|%.*s|%%", -0x7fffffffffffffffll, 0xffffffffffffffffull, 'x', "truncated", 2, "ab");
+        RUN_LOG_TEST("%lc|%d|%c", (wint_t)'y', -42, 'z');         // 32 bits with or without 'l', as they are read right away
+#ifdef PICOFORMAT_HANDLE_FILL
+        RUN_LOG_TEST("[%*s]|%-6d|%05u", 8, "hi", 42, 17u);
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_HEX
+        RUN_LOG_TEST("%x|%X|%llx", 0xdeadbeefu, 0xabcu, 0x123456789abcdefull);
+#endif // PICOFORMAT_HANDLE_HEX
+#ifdef PICOFORMAT_HANDLE_FLOATS
+        RUN_LOG_TEST("%f|%.2f|%.*f", 3.14159, -2.5, 4, 1e10);
+#endif // PICOFORMAT_HANDLE_FLOATS
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+        pico_snprintf(pStdBuf, sizeof(pStdBuf), "%.3Q16|%lQ40|%.*Q15", -0x18000, -0x123456789abll, 2, 0x4000);
+        failed = pico_log_capture(&logRing, "%.3Q16|%lQ40|%.*Q15", -0x18000, -0x123456789abll, 2, 0x4000) < 0;
+        cbSunk = 0;
+        failed = failed || 1 != pico_log_render(&logRing, sink, NULL);
+        pPicoBuf[cbSunk] = '\0';
+        failed = failed || strcmp(pStdBuf, pPicoBuf);
+        if (g_verbose || failed) {
+            printf("picoprintf %s  logged \"%%Q\", -- pico_snprintf() result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf, pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+        struct timespec time = { 1715949296, 123456789 };  // the struct may be gone by the rendering: its value is captured
+        pico_snprintf(pStdBuf, sizeof(pStdBuf), "%.3T|%lT", &time, -1ll);
+        failed = pico_log_capture(&logRing, "%.3T|%lT", &time, -1ll) < 0;
+        time.tv_sec = 0;
+        cbSunk = 0;
+        failed = failed || 1 != pico_log_render(&logRing, sink, NULL);
+        pPicoBuf[cbSunk] = '\0';
+        failed = failed || strcmp(pStdBuf, pPicoBuf) || strcmp("2024-05-17T12:34:56.123Z|1969-12-31T23:59:59.999999Z", pPicoBuf);
+        if (g_verbose || failed) {
+            printf("picoprintf %s  logged \"%%T\", -- pico_snprintf() result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf, pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+    }
+    // wrapping around the end of the ring, many times over, and dropping the records that do not fit
+    for (int ii = 0; ii < 1000 && !failed; ii++) {
+        const char *pLong = "a rather long string that is here just to have lots of characters";
+        snprintf(pStdBuf, sizeof(pStdBuf), "%d: %s\n%d: %s\n", ii, pLong + ii % 50, -ii, pLong + ii % 30);
+        pico_log_capture(&logRing, "%d: %s\n", ii, pLong + ii % 50);
+        pico_log_capture(&logRing, "%d: %s\n", -ii, pLong + ii % 30);
+        cbSunk = 0;
+        failed = 2 != pico_log_render(&logRing, sink, NULL);
+        pPicoBuf[cbSunk] = '\0';
+        failed = failed || strcmp(pStdBuf, pPicoBuf);
+    }
+    for (int ii = 0; pico_log_capture(&logRing, "%d %s", ii, "filling the ring up") >= 0; ii++);
+    failed = failed || 1 != logRing.cDropped || pico_log_capture(&logRing, "%d %s", 0, "filling the ring up") >= 0 || 2 != logRing.cDropped;
+    if (!failed) {                          // offline: a record copied out of the ring, with the format given separately
+        unsigned char pRecord[PICOLOG_MAX_RECORD];
+        pico_log_init(&logRing, pLogBuf, sizeof(pLogBuf), 0);
+        int cbRecord = pico_log_capture(&logRing, "%s=%d", "answer", 42);
+        memcpy(pRecord, pLogBuf, cbRecord);
+        picolen = pico_log_format(pPicoBuf, sizeof(pPicoBuf), pRecord, "%s=%d");
+        failed = strcmp("answer=42", pPicoBuf) || 9 != picolen || 9 != pico_log_format(pPicoBuf, 4, pRecord, "%s=%d") || strcmp("ans", pPicoBuf);
+    }
+    if (g_verbose || failed) {
+        printf("picoprintf %s  logging through the ring: wrapping around, dropping, and decoding offline\n", failed ? "FAILED" : "passed");
+    }
+    failed ? picofailures++ : picopasses++;
+
+    // buffered output to a file descriptor: nothing is written before the flush policy says so, and then all of it, in order
+    int pPipe[2] = { -1, -1 };
+    failed = pipe(pPipe) || fcntl(pPipe[0], F_SETFL, O_NONBLOCK);
+    if (!failed) {
+        pico_set_flush_policy(PICOIO_FLUSH_FULL);
+        failed = 7 != pico_dprintf(pPipe[1], "%s %d\n", "line", 1) || read_written(pPipe[0]);
+        failed = failed || pico_flush() || strcmp("line 1\n", pPicoBuf + !read_written(pPipe[0]));
+        failed = failed || PICOIO_FLUSH_FULL != pico_set_flush_policy(PICOIO_FLUSH_LINE);
+        failed = failed || 3 != pico_dprintf(pPipe[1], "abc") || read_written(pPipe[0]);
+        failed = failed || 4 != pico_dprintf(pPipe[1], "%c%s", 'd', "ef\n") || strcmp("abcdef\n", pPicoBuf + !read_written(pPipe[0]));
+        pico_set_flush_policy(PICOIO_FLUSH_EACH);
+        failed = failed || 2 != pico_dprintf(pPipe[1], "%d", 42) || strcmp("42", pPicoBuf + !read_written(pPipe[0]));
+        pico_set_flush_policy(PICOIO_FLUSH_FULL);   // switching to another fd writes the output pending for the previous one
+        failed = failed || 1 != pico_dprintf(pPipe[1], "x") || pico_dprintf(-1, "%s", "") || strcmp("x", pPicoBuf + !read_written(pPipe[0]));
+    }
+    if (g_verbose || failed) {
+        printf("picoprintf %s  pico_dprintf(): the flush policies, -- last read: \"%s\"\n", failed ? "FAILED" : "passed", pPicoBuf);
+    }
+    failed ? picofailures++ : picopasses++;
+    close(pPipe[0]);
+    close(pPipe[1]);
+    // calls that overflow the buffer, to a file read back afterwards: one that fits a buffer of its own, and one that does not
+    static char pIoExpected[4 * PICOIO_BUFFER_SIZE], pIoRead[4 * PICOIO_BUFFER_SIZE], pIoPadding[3 * PICOIO_BUFFER_SIZE];
+    memset(pIoPadding, '.', sizeof(pIoPadding) - 1);
+    char pIoPath[] = "/tmp/picotest_XXXXXX";
+    g_ioFd = mkstemp(pIoPath);
+    failed = g_ioFd < 0;
+    unlink(pIoPath);
+    int cbExpected = 0;
+    for (int ii = 0; ii < 4 && !failed; ii++) {
+        int len = ii < 3 ? PICOIO_BUFFER_SIZE / 2 + ii : 2 * PICOIO_BUFFER_SIZE + 5;
+        cbExpected += snprintf(pIoExpected + cbExpected, sizeof(pIoExpected) - cbExpected, "<%d:%.*s>", ii, len, pIoPadding);
+        failed = len + 4 != pico_dprintf(g_ioFd, "<%d:%.*s>", ii, len, pIoPadding);
+        // under PICOIO_FLUSH_FULL, a call that fits a buffer is left pending, after writing the calls before it
+        failed = failed || (ii < 3 && cbExpected - (len + 4) != lseek(g_ioFd, 0, SEEK_CUR));
+    }
+    failed = failed || pico_flush() || cbExpected != pread(g_ioFd, pIoRead, sizeof(pIoRead), 0) || memcmp(pIoExpected, pIoRead, cbExpected);
+    if (g_verbose || failed) {
+        printf("picoprintf %s  pico_dprintf() of %d chars through a buffer of %d\n", failed ? "FAILED" : "passed", cbExpected, PICOIO_BUFFER_SIZE);
+    }
+    failed ? picofailures++ : picopasses++;
+    if (g_ioFd >= 0) {                              // threads logging concurrently: every line whole, and in order within its thread
+        pthread_t pThreads[IO_THREADS];
+        failed = ftruncate(g_ioFd, 0) || fcntl(g_ioFd, F_SETFL, O_APPEND);
+        for (size_t ii = 0; ii < IO_THREADS && !failed; ii++) {
+            failed = pthread_create(&pThreads[ii], NULL, log_lines, (void *)ii);
+        }
+        for (size_t ii = 0; ii < IO_THREADS && !failed; ii++) {
+            pthread_join(pThreads[ii], NULL);
+        }
+        int pNextLine[IO_THREADS] = { 0 };
+        FILE *pFile = failed ? NULL : fdopen(g_ioFd, "r");
+        failed = NULL == pFile || fseek(pFile, 0, SEEK_SET);
+        while (!failed && fgets(pStdBuf, sizeof(pStdBuf), pFile)) {
+            int thread, line;
+            failed = 2 != sscanf(pStdBuf, "thread %d line %d: ", &thread, &line) || thread < 0 || thread >= IO_THREADS || line != pNextLine[thread]++;
+            snprintf(pPicoBuf, sizeof(pPicoBuf), "thread %d line %d: %.*s\n", thread, line, line % 40, "padding to vary the length of the lines");
+            failed = failed || strcmp(pStdBuf, pPicoBuf);
+        }
+        for (int ii = 0; ii < IO_THREADS; ii++) {
+            failed = failed || IO_THREAD_LINES != pNextLine[ii];
+        }
+        if (g_verbose || failed) {
+            printf("picoprintf %s  pico_dprintf() from %d threads at once, -- last line: \"%s\"\n", failed ? "FAILED" : "passed", IO_THREADS, pStdBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+        pFile ? fclose(pFile) : close(g_ioFd);
+    }
+    pico_set_flush_policy(PICOIO_FLUSH_LINE);
+
+    {                                               // the append cursor: pieces, a truncation, and the rollbacks
+        char pBuf[16];
+        pico_buf buf;
+        pico_binit(&buf, pBuf, sizeof(pBuf));
+        failed = 6 != pico_bprintf(&buf, "%s=%d", "key", 42);
+        pico_bputc(&buf, ',');
+        pico_bmark mark = pico_bmark_get(&buf);
+        pico_bputs(&buf, "name");
+        failed = failed || strcmp("key=42,name", pBuf) || 11 != buf.cbUsed || buf.truncated;
+        failed = failed || 9 != pico_bprintf(&buf, "=%s", "too long") || strcmp("key=42,name=too", pBuf) || !buf.truncated;
+        pico_bputc(&buf, '!');                      // full: dropped, and still truncated
+        failed = failed || 15 != buf.cbUsed || strcmp("key=42,name=too", pBuf);
+        pico_brollback(&buf, mark);                 // the field that did not fit whole is dropped
+        failed = failed || strcmp("key=42,", pBuf) || 7 != buf.cbUsed || buf.truncated;
+        pico_bmark outer = pico_bmark_get(&buf);
+        pico_bputs(&buf, "a");
+        pico_bmark inner = pico_bmark_get(&buf);
+        pico_bputs(&buf, "bcdefghijklmnop");
+        pico_brollback(&buf, inner);
+        failed = failed || strcmp("key=42,a", pBuf) || buf.truncated;
+        pico_brollback(&buf, outer);
+        failed = failed || strcmp("key=42,", pBuf);
+        pico_binit(&buf, NULL, 0);                  // no buffer: any append but an empty one is truncated
+        pico_bputs(&buf, "");
+        failed = failed || buf.truncated || 3 != pico_bprintf(&buf, "%d", 123) || !buf.truncated || buf.cbUsed;
+        if (g_verbose || failed) {
+            printf("picoprintf %s  pico_buf: appends, truncation, and rollbacks, -- result: \"%s\"\n", failed ? "FAILED" : "passed", pBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+
+    {                                               // the typed kernels against the stdlib, and with a byte too few
+        static const int64_t pValues[] = { 0, 7, -7, 12345, 4294967295ll, -2147483648ll, 9223372036854775807ll, -9223372036854775807ll - 1 };
+        char pKernel[64];
+        failed = false;
+        for (size_t ii = 0; ii < sizeof(pValues) / sizeof(pValues[0]) && !failed; ii++) {
+            char *pEnd = pico_i64toa(pKernel, pKernel + sizeof(pKernel), pValues[ii]);
+            int stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "%lld", (long long)pValues[ii]);
+            failed = !pEnd || stdlen != pEnd - pKernel || memcmp(pStdBuf, pKernel, stdlen) || pico_i64toa(pKernel, pKernel + stdlen - 1, pValues[ii]);
+            pEnd = pico_u64toa(pKernel, pKernel + sizeof(pKernel), (uint64_t)pValues[ii]);
+            stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "%llu", (unsigned long long)pValues[ii]);
+            failed = failed || !pEnd || stdlen != pEnd - pKernel || memcmp(pStdBuf, pKernel, stdlen);
+            pEnd = pico_u32toa(pKernel, pKernel + sizeof(pKernel), (uint32_t)pValues[ii]);
+            stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "%u", (unsigned)pValues[ii]);
+            failed = failed || !pEnd || stdlen != pEnd - pKernel || memcmp(pStdBuf, pKernel, stdlen) || pico_u32toa(pKernel, pKernel + stdlen - 1, (uint32_t)pValues[ii]);
+#ifdef PICOFORMAT_HANDLE_HEX
+            for (int width = 0; width <= 20 && !failed; width += 4) {
+                pEnd = pico_xtoa(pKernel, pKernel + sizeof(pKernel), (uint64_t)pValues[ii], width, ii & 1);
+                stdlen = snprintf(pStdBuf, sizeof(pStdBuf), ii & 1 ? "%0*llX" : "%0*llx", width, (unsigned long long)pValues[ii]);
+                failed = !pEnd || stdlen != pEnd - pKernel || memcmp(pStdBuf, pKernel, stdlen) || pico_xtoa(pKernel, pKernel + stdlen - 1, (uint64_t)pValues[ii], width, 0);
+            }
+#endif // PICOFORMAT_HANDLE_HEX
+#ifdef PICOFORMAT_HANDLE_FLOATS
+            for (int precision = -1; precision <= 9 && !failed; precision += 2) {
+                double val = (double)pValues[ii] / 1024;
+                pEnd = pico_ftoa(pKernel, pKernel + sizeof(pKernel), val, precision);
+                stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "%.*f", precision < 0 ? 6 : precision, val);
+                failed = !pEnd || stdlen != pEnd - pKernel || memcmp(pStdBuf, pKernel, stdlen) || pico_ftoa(pKernel, pKernel + stdlen - 1, val, precision);
+            }
+#endif // PICOFORMAT_HANDLE_FLOATS
+        }
+        for (int width = -8; width <= 8 && !failed; width++) {
+            char *pEnd = pico_strpad(pKernel, pKernel + sizeof(pKernel), "abcd", width);
+            int stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "%*s", width, "abcd");
+            failed = !pEnd || stdlen != pEnd - pKernel || memcmp(pStdBuf, pKernel, stdlen) || pico_strpad(pKernel, pKernel + stdlen - 1, "abcd", width);
+        }
+        failed = failed || pico_u32toa(pKernel, pKernel, 0) || pico_strpad(pKernel, pKernel, "", 0) != pKernel;
+        if (g_verbose || failed) {
+            printf("picoprintf %s  typed kernels, -- stdlib result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+
+    {                                               // the resumable rendering: every chunk size, cutting literals and conversions anywhere
+        const char *pLong = "a string long enough to span several chunks of the smaller sizes";
+        failed = false;
+        for (size_t cbChunk = 1; cbChunk <= 64 && !failed; cbChunk++) {
+            int stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "[%s] #%d: %u, %c, %s; 100%% done, at last", "info", -12345, 4000000000u, 'x', pLong);
+            int picolen = render_chunked(cbChunk, "[%s] #%d: %u, %c, %s; 100%% done, at last", "info", -12345, 4000000000u, 'x', pLong);
+            failed = stdlen != picolen || strcmp(pStdBuf, pPicoBuf);
+#ifdef PICOFORMAT_HANDLE_FILL
+            stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "%-40s|%*d|%08d|%.*s", "left", 30, 42, -7, 12, pLong);
+            picolen = render_chunked(cbChunk, "%-40s|%*d|%08d|%.*s", "left", 30, 42, -7, 12, pLong);
+            failed = failed || stdlen != picolen || strcmp(pStdBuf, pPicoBuf);
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_FLOATS
+            stdlen = snprintf(pStdBuf, sizeof(pStdBuf), "%f %.3f %f", 1e40, -3.14159, 0.5);
+            picolen = render_chunked(cbChunk, "%f %.3f %f", 1e40, -3.14159, 0.5);
+            failed = failed || stdlen != picolen || strcmp(pStdBuf, pPicoBuf);
+#endif // PICOFORMAT_HANDLE_FLOATS
+        }
+        failed = failed || 0 != render_chunked(8, "") || 0 != render_chunked(8, "%s", "");
+        static char pLongStr[20000], pLongStd[20100], pLongPico[20100];    // the conversions longer than any chunk, or the scratch
+        memset(pLongStr, 'z', sizeof(pLongStr) - 1);
+        int stdlen = snprintf(pLongStd, sizeof(pLongStd), "x%sy%.3s", pLongStr, pLongStr);
+        int picolen = render_long_chunked(pLongPico, sizeof(pLongPico), "x%sy%.3s", pLongStr, pLongStr);
+        failed = failed || stdlen != picolen || strcmp(pLongStd, pLongPico);
+#ifdef PICOFORMAT_HANDLE_FILL
+        stdlen = snprintf(pLongStd, sizeof(pLongStd), "%300d|%-*s|%0200.3f", -42, 250, "left", 2.5);
+        picolen = render_long_chunked(pLongPico, sizeof(pLongPico), "%300d|%-*s|%0200.3f", -42, 250, "left", 2.5);
+        failed = failed || stdlen != picolen || strcmp(pLongStd, pLongPico);
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_HEXDUMP
+        for (size_t cbChunk = 1; cbChunk <= 9 && !failed; cbChunk++) {         // the bytes cut between their digits, too
+            picolen = render_chunked(cbChunk, "<%*H|%.0s%3H>", 5, "\x01\xab\xcd\xef\x10", "", "\xff\x00\x7f");
+            failed = 19 != picolen || strcmp("<01ABCDEF10|FF007F>", pPicoBuf);
+        }
+#endif // PICOFORMAT_HANDLE_HEXDUMP
+        failed = failed || 0 != abandon_chunked("%s and %d", "abandoned", 42) || strcmp("aban", pPicoBuf);
+        if (g_verbose || failed) {
+            printf("picoprintf %s  resumable rendering, -- stdlib result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf, pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+
+#ifdef PICOFORMAT_HANDLE_TIMESTAMP
+    {                                               // timestamps against the libc's calendar: leap days, centuries, before 1970
+        static const long long pSeconds[] = { 0, -1, 951782399, 951782400, 951868800, -2208988800ll, -2203891200ll, 4107542399ll,
+            4107542400ll, 1715949296, 253402300799ll, -62167219200ll, 68169600, -86400 * 365ll * 300 };
+        static const int pPrecisions[] = { -1, 0, 1, 3, 6, 9, 12 };
+        failed = false;
+        for (size_t ii = 0; ii < 2000 && !failed; ii++) {
+            long long second = ii < sizeof(pSeconds) / sizeof(pSeconds[0]) ? pSeconds[ii]
+                : (long long)(((unsigned long long)rand() << 31 ^ (unsigned long long)rand()) % 315537897600ull) - 62167219200ll;
+            long nanosecond = (long)(((unsigned long long)rand() << 16 ^ (unsigned long long)rand()) % 1000000000);
+            int precision = pPrecisions[ii % (sizeof(pPrecisions) / sizeof(pPrecisions[0]))];
+            int stdlen = std_timestamp(pStdBuf, sizeof(pStdBuf), (time_t)second, nanosecond, precision < 0 ? 6 : precision > 9 ? 9 : precision);
+            struct timespec time = { (time_t)second, nanosecond };
+            int picolen = precision < 0 ? pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%T", &time)
+                : pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%.*T", precision, &time);
+            failed = stdlen != picolen || strcmp(pStdBuf, pPicoBuf);
+            time.tv_nsec = (nanosecond + 1) % 1000000000;   // the same second again: from the cache, with a fraction of its own
+            if (!failed && second > -(1ll << 33) && second < (1ll << 33)) {
+                std_timestamp(pStdBuf, sizeof(pStdBuf), (time_t)second, time.tv_nsec, 9);
+                picolen = pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%.9lT", second * 1000000000 + time.tv_nsec);
+                failed = 30 != picolen || strcmp(pStdBuf, pPicoBuf);
+            }
+        }
+        struct timespec far = { 253402300800ll, 0 };  // past 9999 and before 0000: the expanded years of ISO 8601
+        failed = failed || 22 != pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%.0T", &far) || strcmp("+10000-01-01T00:00:00Z", pPicoBuf);
+        far.tv_sec = -62167219201ll;
+        failed = failed || 21 != pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%.0T", &far) || strcmp("-0001-12-31T23:59:59Z", pPicoBuf);
+        failed = failed || 24 != pico_snprintf(pPicoBuf, 8, "%.3lT", 0ll) || strcmp("1970-01", pPicoBuf);
+#ifdef PICOFORMAT_HANDLE_FILL
+        failed = failed || 25 != pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%-24.1lT|", 0ll) || strcmp("1970-01-01T00:00:00.0Z  |", pPicoBuf);
+#endif // PICOFORMAT_HANDLE_FILL
+        if (g_verbose || failed) {
+            printf("picoprintf %s  timestamps, -- stdlib result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf, pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+#endif // PICOFORMAT_HANDLE_TIMESTAMP
+
+#ifdef PICOFORMAT_HANDLE_CUSTOM
+    {                                               // the registered conversions: through each entry point, and the refusals
+        failed = pico_register_conversion('I', convert_ipv4) || pico_register_conversion('N', convert_level)
+            || 0 == pico_register_conversion('d', convert_level) || 0 == pico_register_conversion('x', convert_level)
+            || 0 == pico_register_conversion('z', convert_level) || 0 == pico_register_conversion('%', convert_level);
+        const char *pExpected = "[warning] 192.168.1.20:80 err";
+        int len = pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "[%N] %I:%d %.3N", 2, 0xc0a80114u, 80, 3);
+        failed = failed || strcmp(pExpected, pPicoBuf) || 29 != len;
+        failed = failed || 29 != pico_snprintf(pPicoBuf, 12, "[%N] %I:%d %.3N", 2, 0xc0a80114u, 80, 3) || strcmp("[warning] 1", pPicoBuf);
+        failed = failed || 29 != pico_measure("[%N] %I:%d %.3N", 2, 0xc0a80114u, 80, 3);
+        failed = failed || pico_format_compile("[%N] %I:%d %.3N", &compiled, pCompiledOps, 16) < 0
+            || 29 != pico_format_render(&compiled, pPicoBuf, sizeof(pPicoBuf), 2, 0xc0a80114u, 80, 3) || strcmp(pExpected, pPicoBuf);
+        cbSunk = 0;
+        failed = failed || 29 != pico_fctprintf(sink, NULL, "[%N] %I:%d %.3N", 2, 0xc0a80114u, 80, 3);
+        pPicoBuf[cbSunk] = '\0';
+        failed = failed || strcmp(pExpected, pPicoBuf);
+        failed = failed || 3 != pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%d[%q", 42) || strcmp("42[", pPicoBuf);  // neither built in, nor registered
+        unsigned char pRing[PICOLOG_MAX_RECORD];    // the arguments of a custom conversion cannot be copied into a record
+        pico_log_ring ring;
+        failed = failed || pico_log_init(&ring, pRing, sizeof(pRing), 0) || -1 != pico_log_capture(&ring, "%I", 0x7f000001u);
+        if (g_verbose || failed) {
+            printf("picoprintf %s  registered conversions, -- picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+#endif // PICOFORMAT_HANDLE_CUSTOM
+
+#ifdef PICOFORMAT_STATS
+    {                                               // the counters: a few known calls, then more from more threads than slots
+        pico_stats stats;
+        pico_stats_reset();
+        pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%d %s %u", 42, "short", 7u);         // 10 chars
+        pico_snprintf(pPicoBuf, 8, "%s: %d", "a rather long string", -1);              // 24 chars, truncated
+        pico_measure("%c%c", 'a', 'b');                                                 // 2 chars, never truncated
+        pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "no conversion at all, 100%%");      // 26 chars
+        render_chunked(4, "%d %s %u", 42, "short", 7u);                                // 10 chars, a single call in 3 chunks
+        pico_stats_snapshot(&stats);
+        failed = 5 != stats.calls || 72 != stats.bytes || 1 != stats.truncations
+            || 3 != stats.conversions['d' - 'A'] || 3 != stats.conversions['s' - 'A'] || 2 != stats.conversions['u' - 'A']
+            || 2 != stats.conversions['c' - 'A'] || 3 != stats.lengths[0] || 2 != stats.lengths[1] || 0 != stats.lengths[2];
+        pthread_t pThreads[PICOFORMAT_STATS_THREADS + 2];  // the ones past the slots share the last one, and lose no count
+        const int cThreads = (int)(sizeof(pThreads) / sizeof(pThreads[0]));
+        for (int ii = 0; ii < cThreads; ii++) {
+            failed = failed || pthread_create(&pThreads[ii], NULL, format_lines, NULL);
+            if (1 == PICOFORMAT_STATS_THREADS) {    // a single slot without atomics: one thread at a time
+                failed = failed || pthread_join(pThreads[ii], NULL);
+            }
+        }
+        for (int ii = 0; ii < cThreads && PICOFORMAT_STATS_THREADS > 1; ii++) {
+            failed = failed || pthread_join(pThreads[ii], NULL);
+        }
+        failed = failed || pico_stats_snapshot(&stats) < (PICOFORMAT_STATS_THREADS > 1 ? 2 : 1) || 5 + cThreads * STATS_THREAD_LINES != stats.calls
+            || 3 + cThreads * STATS_THREAD_LINES != stats.conversions['d' - 'A'];
+        char pCalls[32], pConversions[32];
+        snprintf(pCalls, sizeof(pCalls), "%d calls (1 truncated)", 5 + cThreads * STATS_THREAD_LINES);
+        snprintf(pConversions, sizeof(pConversions), " %%d: %d", 3 + cThreads * STATS_THREAD_LINES);
+        cbSunk = 0;
+        int len = pico_stats_dump(sink, NULL);
+        pPicoBuf[cbSunk] = '\0';
+        failed = failed || len != (int)cbSunk || !strstr(pPicoBuf, pCalls) || !strstr(pPicoBuf, pConversions);
+        if (g_verbose || failed) {
+            printf("picoprintf %s  the statistics: \n%s", failed ? "FAILED" : "passed", pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+#endif // PICOFORMAT_STATS
+
+#ifdef PICOFORMAT_HANDLE_ARRAYS
+    // integer arrays: compared to a "%d" (or "%llu") per value, with every width, fill, and alignment, and truncated
+    int32_t pInts[40];
+    uint64_t pLongs[40];
+    for (size_t ii = 0; ii < 40; ii++) {
+        pInts[ii] = ii < sizeof(g_testIntegers) / sizeof(g_testIntegers[0]) ? g_testIntegers[ii] : (rand() % 2 ? 1 : -1) * rand() >> (ii % 31);
+        pLongs[ii] = ii < 20 ? 1ull << (ii * 7 % 64) : ((unsigned long long)rand() << 40 ^ (unsigned long long)rand() << 20 ^ rand()) >> (ii % 64);
+        pLongs[ii] -= ii % 3 ? 0 : 1;               // 2^n - 1: all nines, and all the digit counts
+    }
+    const char *pArrayFormats[] = { "%d", "%7d", "%07d", "%-7d", "%llu", "%24llu", "%024llu", "%-24llu" };
+    unsigned pArrayFlags[] = { 0, PICO_ARRAY_WIDTH(7), PICO_ARRAY_WIDTH(7) | PICO_ARRAY_FILL_ZEROS, PICO_ARRAY_WIDTH(7) | PICO_ARRAY_LEFT_ALIGN };
+    for (size_t ii = 0; ii < sizeof(pArrayFormats) / sizeof(pArrayFormats[0]); ii++) {
+        for (size_t cbBuf = sizeof(pPicoBuf); cbBuf > 0; cbBuf = cbBuf > 200 ? 200 : cbBuf / 3) {
+            int cbExpected = 0;
+            size_t cExpected = 0;
+            for (; cExpected < 40; cExpected++) {   // only the values that fit in full, like the array functions
+                char pValue[32];
+                int cbValue = ii < 4 ? snprintf(pValue, sizeof(pValue), pArrayFormats[ii], pInts[cExpected])
+                                     : snprintf(pValue, sizeof(pValue), pArrayFormats[ii], (unsigned long long)pLongs[cExpected]);
+                if (cbExpected + (cExpected ? 1 : 0) + cbValue >= (int)cbBuf) {
+                    break;
+                }
+                cbExpected += snprintf(pStdBuf + cbExpected, sizeof(pStdBuf) - cbExpected, cExpected ? ";%s" : "%s", pValue);
+            }
+            pStdBuf[cbExpected] = '\0';
+            size_t cFit = ii < 4 ? pico_format_i32_array(pPicoBuf, cbBuf, pInts, 40, ';', pArrayFlags[ii % 4])
+                                 : pico_format_u64_array(pPicoBuf, cbBuf, pLongs, 40, ';', pArrayFlags[ii % 4] + (ii % 4 ? 17 : 0));
+            failed = strcmp(pStdBuf, pPicoBuf) || cExpected != cFit;
+            if (g_verbose || failed) {
+                printf("picoprintf %s  array of \"%s\" into %u chars, -- expected: %u \"%s\", picoprintf result: %u \"%s\"\n", failed ? "FAILED" : "passed",
+                       pArrayFormats[ii], (unsigned)cbBuf, (unsigned)cExpected, pStdBuf, (unsigned)cFit, pPicoBuf);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+    }
+#endif // PICOFORMAT_HANDLE_ARRAYS
+
+    // integer parsing: the same values, ends, and overflows as the stdlib, in all the bases, then on random numbers
+    int pBases[] = { 0, 10, 16, 8, 2, 36 };
+    for (size_t ii = 0; ii < sizeof(pBases) / sizeof(pBases[0]); ii++) {
+        size_t cFixed = sizeof(g_pIntegerStrings) / sizeof(g_pIntegerStrings[0]) - 1;
+        for (size_t jj = 0; jj < cFixed + 200; jj++) {
+            const char *pStr = g_pIntegerStrings[jj < cFixed ? jj : cFixed], *pEnd;
+            char *pStdEnd;
+            int err;
+            if (NULL == pStr) {                     // past the fixed ones: random numbers of all lengths
+                snprintf(pStdBuf, sizeof(pStdBuf), jj % 2 ? "%lld" : "%llu", (long long)((unsigned long long)rand() << 42 ^ (unsigned long long)rand() << 21 ^ rand()) >> jj % 63);
+                pStr = pStdBuf;
+            }
+            errno = 0;
+            unsigned long long stdValue = strtoull(pStr, &pStdEnd, pBases[ii]);
+            unsigned long long value = pico_strtou64(pStr, &pEnd, pBases[ii], &err);
+            failed = stdValue != value || pStdEnd != pEnd || (ERANGE == errno) != (PICO_ATOX_OVERFLOW == err) || (pEnd == pStr) != (PICO_ATOX_NO_DIGITS == err);
+            errno = 0;
+            long long stdSigned = strtoll(pStr, &pStdEnd, pBases[ii]);
+            bool outOfRange = ERANGE == errno || stdSigned > 0x7fffffffll || stdSigned < -0x80000000ll;
+            stdSigned = stdSigned > 0x7fffffffll ? 0x7fffffffll : stdSigned < -0x80000000ll ? -0x80000000ll : stdSigned;
+            int32_t signedValue = pico_strtoi32(pStr, &pEnd, pBases[ii], &err);
+            failed = failed || stdSigned != signedValue || pStdEnd != pEnd || outOfRange != (PICO_ATOX_OVERFLOW == err);
+            if (g_verbose || failed) {
+                printf("picoatox %s  \"%s\" in base %d -- stdlib result: %lld, picoatox result: %d (error %d)\n", failed ? "FAILED" : "passed", pStr, pBases[ii], stdSigned, signedValue, err);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+    }
+
+    // floating point parsing: the same bits and ends as the stdlib, on the edge cases, then on random bit patterns printed
+    // with all the precisions, and on the exact midpoints between two doubles, which have to round to the even one
+    {
+        static char pLongBuf[0x400];                // the midpoints have up to 767 significant digits
+        size_t cFixed = sizeof(g_pDoubleStrings) / sizeof(g_pDoubleStrings[0]) - 1;
+        for (size_t ii = 0; ii < cFixed + 3000; ii++) {
+            const char *pStr = g_pDoubleStrings[ii < cFixed ? ii : cFixed], *pEnd;
+            char *pStdEnd;
+            if (NULL == pStr) {
+                union { unsigned long long bits; double val; } random = { 0 }, next;
+                for (int jj = 0; jj < 4; jj++) {
+                    random.bits = (random.bits << 16) ^ (unsigned long long)rand();
+                }
+                next.bits = random.bits + 1;
+                if (ii % 3) {
+                    snprintf(pStdBuf, sizeof(pStdBuf), "%.*g", (int)(ii % 19) + 1, random.val);
+                } else {                            // the midpoint is exact in the 64-bit mantissa of x87 long doubles
+                    snprintf(pLongBuf, sizeof(pLongBuf), "%.*Le", ii % 2 ? 25 : 800, (long double)random.val + ((long double)next.val - random.val) / 2);
+                }
+                pStr = ii % 3 ? pStdBuf : pLongBuf;
+            }
+            union { double val; unsigned long long bits; } stdValue = { strtod(pStr, &pStdEnd) }, value = { pico_strtod(pStr, &pEnd) };
+            union { float val; uint32_t bits; } stdFloat = { strtof(pStr, NULL) }, floatValue = { pico_strtof(pStr, NULL) };
+            failed = pStdEnd != pEnd
+                || (stdValue.val == stdValue.val ? stdValue.bits != value.bits : value.val == value.val)        // NaN payloads aside
+                || (stdFloat.val == stdFloat.val ? stdFloat.bits != floatValue.bits : floatValue.val == floatValue.val);
+            if (g_verbose || failed) {
+                printf("picoatox %s  \"%.40s\" -- stdlib result: %.17g / %.9g, picoatox result: %.17g / %.9g\n", failed ? "FAILED" : "passed", pStr, stdValue.val, stdFloat.val, value.val, floatValue.val);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+    }
+
+    // list parsing: the same values as the single-value parsers, whether the buffer comes whole or split in two chunks at
+    // any position, the number cut by the split being left for the second chunk; then the stops at malformed numbers
+    {
+        const char pList[] = "  42,-7;\t1e3, 3.25\r\n-0.5 ,, 9223372036854775807;-9223372036854775808\n 18,0.1,\n\n 123456789012";
+        const size_t cbList = sizeof(pList) - 1;
+        int64_t pIntegers[16], pExpectedIntegers[16];
+        double pDoubles[16], pExpectedDoubles[16];
+        size_t cExpected = 0;
+        for (const char *pCur = pList; *pCur; cExpected++) {
+            for (; ',' == *pCur || ';' == *pCur || (unsigned char)*pCur <= ' '; pCur++);
+            pExpectedDoubles[cExpected] = pico_strtod(pCur, &pCur);
+        }
+        for (size_t split = 0; split <= cbList; split++) {
+            const char *pStop;
+            int err;
+            size_t cFirst = pico_parse_f64_list(pList, split, pDoubles, 16, &pStop, 0, &err);
+            size_t cDoubles = cFirst + pico_parse_f64_list(pStop, pList + cbList - pStop, pDoubles + cFirst, 16 - cFirst, &pStop, PICO_LIST_LAST, &err);
+            failed = cExpected != cDoubles || pList + cbList != pStop || PICO_ATOX_OK != err || 0 != memcmp(pDoubles, pExpectedDoubles, cExpected * sizeof(double));
+            if (g_verbose || failed) {
+                printf("picoatox %s  f64 list split at %u -- %u values expected, %u parsed\n", failed ? "FAILED" : "passed", (unsigned)split, (unsigned)cExpected, (unsigned)cDoubles);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+        const char pIntList[] = "1 -2,3;-9223372036854775808\t9223372036854775807\n0012\n";
+        for (size_t split = 0; split < sizeof(pIntList); split++) {
+            const char *pStop;
+            int err;
+            size_t cFirst = pico_parse_i64_list(pIntList, split, pIntegers, 16, &pStop, 0, &err);
+            size_t cIntegers = cFirst + pico_parse_i64_list(pStop, pIntList + sizeof(pIntList) - 1 - pStop, pIntegers + cFirst, 16 - cFirst, &pStop, PICO_LIST_LAST, &err);
+            pExpectedIntegers[0] = 1, pExpectedIntegers[1] = -2, pExpectedIntegers[2] = 3, pExpectedIntegers[3] = INT64_MIN, pExpectedIntegers[4] = INT64_MAX, pExpectedIntegers[5] = 12;
+            failed = 6 != cIntegers || PICO_ATOX_OK != err || 0 != memcmp(pIntegers, pExpectedIntegers, 6 * sizeof(int64_t));
+            if (g_verbose || failed) {
+                printf("picoatox %s  i64 list split at %u -- 6 values expected, %u parsed\n", failed ? "FAILED" : "passed", (unsigned)split, (unsigned)cIntegers);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+        const char *pBadLists[] = { "1,2x,3", "1 2 9223372036854775808", "4;1.5", "5,-,6", "7 8 9 10" };
+        const int pBadErrors[] = { PICO_ATOX_NO_DIGITS, PICO_ATOX_OVERFLOW, PICO_ATOX_NO_DIGITS, PICO_ATOX_NO_DIGITS, PICO_ATOX_OK };
+        const size_t pBadCounts[] = { 1, 2, 1, 1, 3 };           // the last one is full after three values
+        for (size_t ii = 0; ii < sizeof(pBadLists) / sizeof(pBadLists[0]); ii++) {
+            const char *pStop;
+            int err;
+            size_t cIntegers = pico_parse_i64_list(pBadLists[ii], strlen(pBadLists[ii]), pIntegers, 3, &pStop, PICO_LIST_LAST, &err);
+            failed = pBadCounts[ii] != cIntegers || pBadErrors[ii] != err || (PICO_ATOX_OK != err && !strchr(",; ", pStop[-1]));
+            if (g_verbose || failed) {
+                printf("picoatox %s  i64 list \"%s\" -- stopped at \"%s\" after %u values (error %d)\n", failed ? "FAILED" : "passed", pBadLists[ii], pStop, (unsigned)cIntegers, err);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+        const char *pBadDoubleLists[] = { "1.5,-1e999,2", "2 1e309", "inf;-Infinity 1e308" };
+        const int pBadDoubleErrors[] = { PICO_ATOX_OVERFLOW, PICO_ATOX_OVERFLOW, PICO_ATOX_OK };
+        const size_t pBadDoubleCounts[] = { 1, 1, 3 };          // the infinities by name are no overflow
+        for (size_t ii = 0; ii < sizeof(pBadDoubleLists) / sizeof(pBadDoubleLists[0]); ii++) {
+            const char *pStop;
+            int err;
+            size_t cDoubles = pico_parse_f64_list(pBadDoubleLists[ii], strlen(pBadDoubleLists[ii]), pDoubles, 3, &pStop, PICO_LIST_LAST, &err);
+            failed = pBadDoubleCounts[ii] != cDoubles || pBadDoubleErrors[ii] != err || (PICO_ATOX_OK != err && !strchr(",; ", pStop[-1]));
+            if (g_verbose || failed) {
+                printf("picoatox %s  f64 list \"%s\" -- stopped at \"%s\" after %u values (error %d)\n", failed ? "FAILED" : "passed", pBadDoubleLists[ii], pStop, (unsigned)cDoubles, err);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+    }
+
+    // scanning: single conversions, then a whole line
+    RUN_SCANF_TEST(int, "42", "%d");
+    RUN_SCANF_TEST(int, "  -17xyz", "%d");
+    RUN_SCANF_TEST(int, "+5", "%d");
+    RUN_SCANF_TEST(int, "abc", "%d");
+    RUN_SCANF_TEST(int, "", "%d");
+    RUN_SCANF_TEST(int, "   ", "%d");
+    RUN_SCANF_TEST(int, "-", "%d");
+    RUN_SCANF_TEST(int, "12345", "%3d");
+    RUN_SCANF_TEST(int, "  12345", "%3d");
+    RUN_SCANF_TEST(int, "0x1F", "%i");
+    RUN_SCANF_TEST(int, "017", "%i");
+    RUN_SCANF_TEST(int, "-0", "%i");
+#ifndef PICOFORMAT_HANDLE_BIN
+    RUN_SCANF_TEST(int, "0b101", "%i");                 // a 0, then "b101"
+    RUN_SCANF_TEST(int, "-0B1", "%i");
+#endif // PICOFORMAT_HANDLE_BIN
+    RUN_SCANF_TEST(unsigned, "4294967295", "%u");
+    RUN_SCANF_TEST(unsigned, "-1", "%u");
+    RUN_SCANF_TEST(int, "x5", "x%d");
+    RUN_SCANF_TEST(int, "x", "x%d");
+    RUN_SCANF_TEST(int, "y5", "x%d");
+    RUN_SCANF_TEST(int, " \t 5 %", "%d %%");
+    RUN_SCANF_TEST(int, "12 34", "%*d %d");
+    RUN_SCANF_TEST(int, "a=\n 7", "a = %d");
+    RUN_SCANF_TEST(short, "-32768", "%hd");
+    RUN_SCANF_TEST(signed char, "-5", "%hhd");
+    RUN_SCANF_TEST(unsigned char, "200", "%hhu");
+    RUN_SCANF_TEST(long, "-1234567890", "%ld");
+    RUN_SCANF_TEST(long long, "9223372036854775807", "%lld");
+    RUN_SCANF_TEST(unsigned long long, "18446744073709551615", "%llu");
+    RUN_SCANF_TEST(size_t, "4096", "%zu");
+    RUN_SCANF_TEST(intmax_t, "-99", "%jd");
+    RUN_SCANF_TEST(int, "abc", "ab%n");
+    RUN_SCANF_TEST(char, "abc", "%c");
+    RUN_SCANF_TEST(char, " x", "%c");
+    RUN_SCANF_TEST(char, "", "%c");
+    RUN_SCANF_STRING_TEST("abc", "%2c");
+    RUN_SCANF_STRING_TEST("a", "%2c");
+    RUN_SCANF_STRING_TEST("hello world", "%s");
+    RUN_SCANF_STRING_TEST("  hello", "%5s");
+    RUN_SCANF_STRING_TEST("abcdef", "%3s");
+    RUN_SCANF_STRING_TEST("key=value", "%[^=]");
+    RUN_SCANF_STRING_TEST("abc123", "%[a-z]");
+    RUN_SCANF_STRING_TEST("]x]y", "%[]x]");
+    RUN_SCANF_STRING_TEST("a-b-c_d", "%[-a-c]");
+    RUN_SCANF_STRING_TEST("123", "%[a-z]");
+    RUN_SCANF_STRING_TEST("  abc", "%[a-z]");
+    RUN_SCANF_STRING_TEST("abcdefgh", "%4[a-z]");
+#ifdef PICOFORMAT_HANDLE_HEX
+    RUN_SCANF_TEST(unsigned, "ff", "%x");
+    RUN_SCANF_TEST(unsigned, "0xDEADbeef", "%X");
+    RUN_SCANF_TEST(unsigned, "-0x10", "%x");
+    RUN_SCANF_TEST(unsigned, "1fz", "%2x");
+    RUN_SCANF_TEST(void *, "0x12345678", "%p");
+#endif // PICOFORMAT_HANDLE_HEX
+#ifdef PICOFORMAT_HANDLE_OCT
+    RUN_SCANF_TEST(unsigned, "777", "%o");
+    RUN_SCANF_TEST(unsigned, "0778", "%o");
+#endif // PICOFORMAT_HANDLE_OCT
+#ifdef PICOFORMAT_HANDLE_FLOATS
+    RUN_SCANF_TEST(float, "3.25", "%f");
+    RUN_SCANF_TEST(float, "-1e-3", "%e");
+    RUN_SCANF_TEST(float, "1e40", "%g");
+    RUN_SCANF_TEST(float, "0.1", "%f");
+    RUN_SCANF_TEST(float, "inf", "%f");
+    RUN_SCANF_TEST(float, "-nan", "%f");
+    RUN_SCANF_TEST(double, "0.1", "%lf");
+    RUN_SCANF_TEST(double, "123.456e7xyz", "%lf");
+    RUN_SCANF_TEST(double, "  2.5e10", "%5lf");
+    RUN_SCANF_TEST(double, ".", "%lf");
+    RUN_SCANF_TEST(double, "2.2250738585072011e-308", "%lG");
+    {
+        const char *pLine = "temp=23.57 id=42 name=probe7 flags=0x1f rest";
+        float stdTemp = 0, picoTemp = 0;
+        int stdId = 0, picoId = 0, stdEnd = 0, picoEnd = 0;
+        char pStdName[8] = "", pPicoName[8] = "";
+        int stdResult = sscanf(pLine, "temp=%f id=%d name=%7s flags=%*i%n", &stdTemp, &stdId, pStdName, &stdEnd);
+        int picoResult = pico_sscanf(pLine, "temp=%f id=%d name=%7s flags=%*i%n", &picoTemp, &picoId, pPicoName, &picoEnd);
+        failed = 3 != picoResult || stdResult != picoResult || stdTemp != picoTemp || stdId != picoId || strcmp(pStdName, pPicoName) || stdEnd != picoEnd;
+        if (g_verbose || failed) {
+            printf("picoscanf %s  \"%s\" -- stdlib result: %d (end %d), picoscanf result: %d (end %d)\n", failed ? "FAILED" : "passed", pLine, stdResult, stdEnd, picoResult, picoEnd);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+#endif // PICOFORMAT_HANDLE_FLOATS
+
+    // too small of a buffer
+    RUN_TRUNCATED_TEST(6, "%d", 1234567);
+    RUN_TRUNCATED_TEST(6, "%d", -1234567);
+    RUN_TRUNCATED_TEST(6, "%s, world!", "hello");
+    RUN_TRUNCATED_TEST(6, "%s%d", "abc", 12345);
+    RUN_TRUNCATED_TEST(1, "%s", "hello");
+    stdlen = strlen("hello, world");
+    picolen = pico_snprintf(NULL, 0, "%s, %s", "hello", "world");
+    failed = stdlen != picolen || stdlen != pico_measure("%s, %s", "hello", "world");
+    if (g_verbose || failed) {
+        printf("picoprintf %s  measuring \"hello, world\": %d\n", failed ? "FAILED" : "passed", picolen);
+    }
+    failed ? picofailures++ : picopasses++;
+
     srand((unsigned)time(NULL));
 
     for (const char **ppFormat = g_pIntegerFormats; NULL != *ppFormat; ppFormat++) {
@@ -151,6 +1157,16 @@ int main(int argc, const char ** argv) {
         }
     }
 
+    for (int len = 0; len < 40; len++) {            // literals of every length on both sides of a specifier, at every alignment
+        static char pFormatBuf[64];
+        const char *pLetters = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGH";
+        for (int offset = 0; offset < 8; offset++) {
+            snprintf(pFormatBuf + offset, sizeof(pFormatBuf) - offset, "%.*s%%s%.*s", len / 2, pLetters, len - len / 2, pLetters + 3);
+            RUN_TEST(pFormatBuf + offset, pLetters + len);
+            RUN_TRUNCATED_TEST(len / 2 + 3, pFormatBuf + offset, pLetters);
+        }
+    }
+
 #ifdef PICOFORMAT_HANDLE_FLOATS
     for (const char **ppFormat = g_pFloatFormats; NULL != *ppFormat; ppFormat++) {
         for (size_t ii = 0; ii < sizeof(g_testFloats) / sizeof(g_testFloats[0]); ii++) {
@@ -163,6 +1179,61 @@ int main(int argc, const char ** argv) {
     }
 #endif // PICOFORMAT_HANDLE_FLOATS
 
+#ifdef PICOFORMAT_HANDLE_FLOATS
+    for (const char **ppFormat = g_pDoubleFormats; NULL != *ppFormat; ppFormat++) {
+        for (size_t ii = 0; ii < sizeof(g_testDoubles) / sizeof(g_testDoubles[0]); ii++) {
+            RUN_TEST(*ppFormat, g_testDoubles[ii]);
+        }
+        for (size_t ii = 0; ii < 50; ii++) {        // random bit patterns: subnormals, huge and tiny exponents, NaNs
+            union { unsigned long long bits; double val; } random = { 0 };
+            for (int jj = 0; jj < 4; jj++) {
+                random.bits = (random.bits << 16) ^ (unsigned long long)rand();
+            }
+            RUN_TEST(*ppFormat, random.val);
+        }
+    }
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+    for (size_t ii = 0; ii < 1000; ii++) {          // "%r" has no stdlib counterpart: it has to read back to the same bits
+        union { unsigned long long bits; double val; } random = { 0 }, readback;
+        for (int jj = 0; jj < 4; jj++) {
+            random.bits = (random.bits << 16) ^ (unsigned long long)rand();
+        }
+        if (ii < sizeof(g_testDoubles) / sizeof(g_testDoubles[0])) {
+            random.val = g_testDoubles[ii];
+        }
+        if (random.val != random.val) {
+            continue;                               // NaN never reads back equal
+        }
+        pico_snprintf(pPicoBuf, sizeof(pPicoBuf), "%r", random.val);
+        readback.val = strtod(pPicoBuf, NULL);
+        snprintf(pStdBuf, sizeof(pStdBuf), "%.17g", random.val);
+        failed = random.bits != readback.bits || strlen(pPicoBuf) > strlen(pStdBuf);
+        if (g_verbose || failed) {
+            printf("picoprintf %s  \"%%r\", -- %%.17g: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf, pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+#endif // PICOFORMAT_HANDLE_FLOATS
+
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+    for (fixed_format *pFormat = g_pFixedFormats; NULL != pFormat->pFixed; pFormat++) {
+        for (size_t ii = 0; ii < 200; ii++) {
+            long long val = ii < sizeof(g_testFixed) / sizeof(g_testFixed[0]) ? g_testFixed[ii]
+                : (long long)((unsigned long long)rand() << 42 ^ (unsigned long long)rand() << 21 ^ rand()) >> ii % 63;
+            val = pFormat->isLong ? val : (int)val;
+            stdlen = snprintf(pStdBuf, sizeof(pStdBuf), pFormat->pFloat, (long double)val / (long double)(1ull << pFormat->bits));
+            picolen = pFormat->isLong ? pico_snprintf(pPicoBuf, sizeof(pPicoBuf), pFormat->pFixed, val) : pico_snprintf(pPicoBuf, sizeof(pPicoBuf), pFormat->pFixed, (int)val);
+            failed = strcmp(pStdBuf, pPicoBuf) || stdlen != picolen
+                || stdlen != (pFormat->isLong ? pico_measure(pFormat->pFixed, val) : pico_measure(pFormat->pFixed, (int)val));
+            if (g_verbose || failed) {
+                printf("picoprintf %s  \"%s\" of %lld, -- stdlib %s: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pFormat->pFixed, val, pFormat->pFloat, pStdBuf, pPicoBuf);
+            }
+            failed ? picofailures++ : picopasses++;
+        }
+    }
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+
 #ifdef PICOFORMAT_HANDLE_WCHAR_T
     RUN_TEST("%S", "should fail");
 #endif // PICOFORMAT_HANDLE_WCHAR_T
@@ -0,0 +1,103 @@
+#include "picoprintf.hpp"
+
+#include <stdio.h>  // printf() for messages and snprintf() for comparison
+#include <string.h> // strcmp()
+
+
+char pStdBuf[0x200];
+char pPicoBuf[0x200];
+
+bool g_verbose = false;
+unsigned picopasses = 0, picofailures = 0;
+
+
+// the formats parsed at compile time must render the same as the stdlib, and as the interpreted ones
+#define RUN_TEST(fmt, ...) { \
+        int stdlen = snprintf(pStdBuf, sizeof(pStdBuf), fmt, __VA_ARGS__); \
+        int picolen = pico::format<fmt>(pPicoBuf, sizeof(pPicoBuf), __VA_ARGS__); \
+        bool failed = strcmp(pStdBuf, pPicoBuf) || stdlen != picolen || stdlen != pico::measure<fmt>(__VA_ARGS__); \
+        if (!failed) { \
+            picolen = pico::format<fmt>(pPicoBuf, 4, __VA_ARGS__);  /* truncated */ \
+            failed = strncmp(pStdBuf, pPicoBuf, 3) || stdlen != picolen; \
+            pico_snprintf(pPicoBuf, sizeof(pPicoBuf), fmt, __VA_ARGS__); \
+            failed = failed || strcmp(pStdBuf, pPicoBuf); \
+        } \
+        if (g_verbose || failed) { \
+            printf("picoprintf.hpp %s  \"%s\", -- stdlib result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", fmt, pStdBuf, pPicoBuf); \
+        } \
+        failed ? picofailures++ : picopasses++; \
+    }
+
+
+// type checking: a mismatch is a compile error, which `pico::arguments_match` tells ahead of time
+static_assert(pico::arguments_match<"%d %s", int, const char *>);
+static_assert(pico::arguments_match<"%d %s", short, char[6]>);
+static_assert(pico::arguments_match<"%ld %lu", long long, unsigned long long>);
+static_assert(!pico::arguments_match<"%d", long long>, "%d reads an int, not a long long");
+static_assert(!pico::arguments_match<"%ld", int>, "%ld reads 64 bits, not an int");
+static_assert(!pico::arguments_match<"%s", int>);
+static_assert(!pico::arguments_match<"%d", const char *>);
+static_assert(!pico::arguments_match<"%d %d", int>, "too few arguments");
+static_assert(!pico::arguments_match<"%d", int, int>, "too many arguments");
+static_assert(pico::arguments_match<"%.*s", int, const char *>);
+static_assert(!pico::arguments_match<"%.*s", const char *, int>);
+#ifdef PICOFORMAT_HANDLE_FLOATS
+static_assert(pico::arguments_match<"%f", float>);
+static_assert(!pico::arguments_match<"%f", int>);
+#endif // PICOFORMAT_HANDLE_FLOATS
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+static_assert(pico::arguments_match<"%Q16 %lQ40", int, long long>);
+static_assert(!pico::arguments_match<"%Q16", long long>, "%Q16 reads an int, not a long long");
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+
+
+int main(int argc, const char **argv) {
+    g_verbose = argc > 1 && 0 == strcmp(argv[1], "-v");
+
+    RUN_TEST("%s", "");
+    RUN_TEST("%s, world!", "hello");
+    RUN_TEST("%s%c %s%c", "hello", ',', "world", '!');
+    RUN_TEST("100%% %s", "sure");
+    RUN_TEST("%d|%i|%u", -17, 2147483647, 4294967295u);
+    RUN_TEST("%ld|%lld|%llu", -4294967296l, -0x7fffffffffffffffll - 1, 0xffffffffffffffffull);
+    RUN_TEST("[%.*s]", 3, "hello, world!");
+#ifdef PICOFORMAT_HANDLE_FILL
+    RUN_TEST("[%6d|%-6d|%06d]", -42, -42, -42);
+    RUN_TEST("[%*s|%-*s]", 8, "right", 8, "left");
+    RUN_TEST("[%*.*s]", 8, 3, "hello, world!");
+#endif // PICOFORMAT_HANDLE_FILL
+#ifdef PICOFORMAT_HANDLE_FORCEDSIGN
+    RUN_TEST("%+d %+d", 5, -5);
+#endif // PICOFORMAT_HANDLE_FORCEDSIGN
+#ifdef PICOFORMAT_HANDLE_OCT
+    RUN_TEST("%o", 0755u);
+#endif // PICOFORMAT_HANDLE_OCT
+#ifdef PICOFORMAT_HANDLE_HEX
+    RUN_TEST("%x %X %lx", 0xcafeu, 0xbeefu, 0x123456789abcdeful);
+#ifdef PICOFORMAT_HANDLE_FILL
+    RUN_TEST("0x%08x 0x%016llx", 0xcafeu, 0xbeefull);
+#endif // PICOFORMAT_HANDLE_FILL
+#endif // PICOFORMAT_HANDLE_HEX
+#ifdef PICOFORMAT_HANDLE_FLOATS
+    RUN_TEST("%f %.2f %.0f", 3.14159, -2.5, 2.5);
+    RUN_TEST("%.3f", 0.1f);
+#ifdef PICOFORMAT_HANDLE_EXPONENTS
+    RUN_TEST("%e %g %G", 6.02214076e23, 0.0001234, 1e-10);
+#endif // PICOFORMAT_HANDLE_EXPONENTS
+#endif // PICOFORMAT_HANDLE_FLOATS
+    RUN_TEST("[%s] temperature sensor #%d reports %d, %d and %d at tick %u", "info", 7, 21, -3, 42, 1234567u);
+#ifdef PICOFORMAT_HANDLE_FIXEDPOINT
+    {   // no stdlib counterpart: the interpreted format is the reference
+        int stdlen = pico_snprintf(pStdBuf, sizeof(pStdBuf), "[%.3Q16|%lQ40|%.0Q1]", -0x18000, 0x123456789abll, 3);
+        int picolen = pico::format<"[%.3Q16|%lQ40|%.0Q1]">(pPicoBuf, sizeof(pPicoBuf), -0x18000, 0x123456789abll, 3);
+        bool failed = strcmp(pStdBuf, pPicoBuf) || stdlen != picolen;
+        if (g_verbose || failed) {
+            printf("picoprintf.hpp %s  \"%%Q\", -- pico_snprintf() result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pStdBuf, pPicoBuf);
+        }
+        failed ? picofailures++ : picopasses++;
+    }
+#endif // PICOFORMAT_HANDLE_FIXEDPOINT
+
+    printf("\n\n Passed: %u\n Failed: %u\n\n", picopasses, picofailures);
+    return picofailures;
+}
@@ -0,0 +1,73 @@
+#define PICOPRINTF_IMPLEMENTATION           // the single-header mode: picoprintf.c is compiled into this file, not linked
+#include "picoprintf.h"
+
+#include <stdbool.h>
+#include <stdio.h>  // printf() for messages and snprintf() for comparison
+#include <string.h> // strcmp()
+
+
+char pStdBuf[0x200];
+char pPicoBuf[0x200];
+
+bool g_verbose = false;
+unsigned picopasses = 0, picofailures = 0;
+
+// the same format, but unknown to the compiler: it always goes through the interpreter
+const char *volatile g_pRuntimeFormat;
+
+
+// the constant format (specialized where one of the fast paths matches) against the stdlib, and against the interpreter,
+// into the whole buffer and truncated to 4 chars
+#define RUN_TEST(format, ...) { \
+        int stdlen = snprintf(pStdBuf, sizeof(pStdBuf), format, __VA_ARGS__); \
+        int picolen = pico_snprintf(pPicoBuf, sizeof(pPicoBuf), format, __VA_ARGS__); \
+        bool failed = strcmp(pStdBuf, pPicoBuf) || stdlen != picolen; \
+        if (!failed) { \
+            picolen = pico_snprintf(pPicoBuf, 4, format, __VA_ARGS__); \
+            failed = strncmp(pStdBuf, pPicoBuf, 3) || stdlen != picolen || stdlen != pico_snprintf(NULL, 0, format, __VA_ARGS__); \
+        } \
+        if (!failed) { \
+            g_pRuntimeFormat = format; \
+            pico_snprintf(pPicoBuf, sizeof(pPicoBuf), g_pRuntimeFormat, __VA_ARGS__); \
+            failed = strcmp(pStdBuf, pPicoBuf); \
+        } \
+        if (g_verbose || failed) { \
+            printf("picoprintf header-only %s  \"%s\", -- stdlib result: \"%s\", picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", format, pStdBuf, pPicoBuf); \
+        } \
+        failed ? picofailures++ : picopasses++; \
+    }
+
+
+int main(int argc, const char **argv) {
+    g_verbose = argc > 1 && 0 == strcmp(argv[1], "-v");
+
+    static const int pInts[] = { 0, 7, -7, 12345, -2147483647 - 1, 2147483647 };
+    for (size_t ii = 0; ii < sizeof(pInts) / sizeof(pInts[0]); ii++) {
+        RUN_TEST("%d", pInts[ii]);
+        RUN_TEST("%u", (unsigned)pInts[ii]);
+        RUN_TEST("[%d]", pInts[ii]);               // not one of the constant formats: interpreted
+#ifdef PICOFORMAT_HANDLE_HEX
+        RUN_TEST("%x", (unsigned)pInts[ii]);
+#ifdef PICOFORMAT_HANDLE_FILL
+        RUN_TEST("%08x", (unsigned)pInts[ii]);
+#endif // PICOFORMAT_HANDLE_FILL
+#endif // PICOFORMAT_HANDLE_HEX
+    }
+    RUN_TEST("%s", "");
+    RUN_TEST("%s", "hello, world!");
+    RUN_TEST("%s!", "hello");
+
+    // a format that is a constant, but only after inlining, takes the same path as a literal
+    const char *pFormat = "%d";
+    RUN_TEST(pFormat, 42);
+
+    int len = pico_sprintf(pPicoBuf, "%s=%d", "answer", 42);
+    bool failed = strcmp("answer=42", pPicoBuf) || 9 != len;
+    if (g_verbose || failed) {
+        printf("picoprintf header-only %s  pico_sprintf(), -- picoprintf result: \"%s\"\n", failed ? "FAILED" : "passed", pPicoBuf);
+    }
+    failed ? picofailures++ : picopasses++;
+
+    printf("\n\n Passed: %u\n Failed: %u\n\n", picopasses, picofailures);
+    return picofailures;
+}